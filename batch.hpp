@@ -0,0 +1,366 @@
+/**@file
+ * @brief Saturating operations over whole arrays.
+ *
+ * The kernels in `saturating::batch` produce the same results as their scalar counterparts applied
+ * element by element, but process a full SIMD register per step. Every kernel takes plain value
+ * arrays; overloads taking arrays of `saturating::type` use the limits of that type.
+ * Input and output arrays may be the same (in place operation), but must not partially overlap.
+ *
+ * Floating point kernels respect NaN handling, don't compile them with `-ffinite-math-only`
+ * (implied by `-ffast-math`) unless NaN never reaches them.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+#include "./types.hpp"
+#include "./simd.hpp"
+
+namespace saturating::batch {
+    /** What to do with NaN inputs of floating point kernels. */
+    enum class nan_policy {
+        propagate,      //< NaN stays NaN
+        flush_to_zero,  //< NaN becomes zero (or the limit nearest to zero)
+        saturate        //< NaN becomes the limit matching its sign bit
+    };
+
+    namespace detail {
+        /** Clip `x` (scalar or vector) to `lo ... hi` applying NaN policy `P`. */
+        template <nan_policy P, typename V, typename T>
+        constexpr V clip(const V& x, const T& lo, const T& hi) noexcept {
+            // Comparisons with NaN are false, so this form lets NaN through untouched
+            const V clipped = x < lo ? V{} + lo : (x > hi ? V{} + hi : x);
+            if constexpr (P == nan_policy::propagate) {
+                return clipped;
+            } else if constexpr (P == nan_policy::flush_to_zero) {
+                const T zero = lo > 0 ? lo : (hi < 0 ? hi : T{0});
+                return x != x ? V{} + zero : clipped;
+            } else {
+                using M = std::conditional_t<std::is_floating_point_v<V>,
+                                             simd::mask_lane_t<T>,
+                                             simd::vector_t<simd::mask_lane_t<T>, sizeof(V) / sizeof(T)>>;
+                M bits {};
+                static_assert(sizeof(bits) == sizeof(x));
+                __builtin_memcpy(&bits, &x, sizeof(bits));
+                return x != x ? (bits < 0 ? V{} + lo : V{} + hi) : clipped;
+            }
+        }
+
+        // Specialized rather than `is_type_v<S> && ...`, which would fail on `S::value_type` for plain types
+
+        template <typename S, bool = is_type_v<S>>
+        constexpr bool is_floating_type_v = false;
+
+        template <typename S>
+        constexpr bool is_floating_type_v<S, true> = std::is_floating_point_v<typename S::value_type>;
+
+        template <typename S, bool = is_type_v<S>>
+        constexpr bool is_integral_type_v = false;
+
+        template <typename S>
+        constexpr bool is_integral_type_v<S, true> = std::is_integral_v<typename S::value_type>;
+
+        /** Lane type twice as wide as `T`, with the same signedness. */
+        template <typename T>
+        using wide_lane_t = std::conditional_t<sizeof(T) == 1, std::conditional_t<std::is_signed_v<T>, int16_t, uint16_t>,
+                            std::conditional_t<sizeof(T) == 2, std::conditional_t<std::is_signed_v<T>, int32_t, uint32_t>,
+                                                               std::conditional_t<std::is_signed_v<T>, int64_t, uint64_t>>>;
+
+        /** Integral types of up to 32 bits are processed in vectors of double width lanes. */
+        template <typename S>
+        constexpr bool has_wide_lanes_v = is_integral_type_v<S> && sizeof(typename S::value_type) <= sizeof(int32_t);
+
+        /** View an array of saturating types as its plain values (a saturating type only holds its value). */
+        template <typename S>
+        inline typename S::value_type* values(S* p) noexcept { return reinterpret_cast<typename S::value_type*>(p); }
+
+        template <typename S>
+        inline const typename S::value_type* values(const S* p) noexcept { return reinterpret_cast<const typename S::value_type*>(p); }
+
+        /**
+         * Apply `f` to the inputs widened to `wide_lane_t`, clamping its (wide) result back into `S`.
+         */
+        template <typename S, typename F, typename... In>
+        inline void transform_wide(F&& f, S* out, std::size_t n, const In*... in) noexcept {
+            using T = typename S::value_type;
+            using W = wide_lane_t<T>;
+            simd::transform<simd::lanes<W>>([&f](const auto&... x) noexcept {
+                return simd::convert<T>(clip<nan_policy::propagate>(f(simd::convert<W>(x)...),
+                                                                    static_cast<W>(S::min_val),
+                                                                    static_cast<W>(S::max_val)));
+            }, values(out), n, values(in)...);
+        }
+    } // namespace detail
+
+    /**
+     * Clip `n` values of `in` to `lo ... hi` into `out`. For floating point values the limits need not be integral.
+     * @param  in  Input values
+     * @param  out Output values
+     * @param  n   Number of elements
+     * @param  lo  Lower limit
+     * @param  hi  Upper limit
+     */
+    template <nan_policy P = nan_policy::propagate, typename T>
+    inline std::enable_if_t<std::is_arithmetic_v<T> && !is_type_v<T>>
+    clip(const T* in, T* out, std::size_t n, const T lo, const T hi) noexcept {
+        simd::transform([lo, hi](const auto& x) noexcept { return detail::clip<P>(x, lo, hi); }, out, n, in);
+    }
+
+    /**
+     * Clip `n` values of the saturating type `S` to `lo ... hi` (within the limits of `S`) into `out`.
+     */
+    template <nan_policy P = nan_policy::propagate, typename S>
+    inline std::enable_if_t<is_type_v<S>>
+    clip(const S* in, S* out, std::size_t n, const typename S::value_type lo, const typename S::value_type hi) noexcept {
+        clip<P>(detail::values(in), detail::values(out), n, lo, hi);
+    }
+
+    /**
+     * Add `n` pairs `a[i] + b[i]` into `out`, clipped to `lo ... hi`.
+     */
+    template <nan_policy P = nan_policy::propagate, typename T>
+    inline std::enable_if_t<std::is_floating_point_v<T>>
+    add(const T* a, const T* b, T* out, std::size_t n, const T lo, const T hi) noexcept {
+        simd::transform([lo, hi](const auto& x, const auto& y) noexcept { return detail::clip<P>(x + y, lo, hi); }, out, n, a, b);
+    }
+
+    /**
+     * Add the constant `offset` to `n` values into `out`, clipped to `lo ... hi`.
+     */
+    template <nan_policy P = nan_policy::propagate, typename T>
+    inline std::enable_if_t<std::is_floating_point_v<T>>
+    add(const T* a, const T offset, T* out, std::size_t n, const T lo, const T hi) noexcept {
+        simd::transform([offset, lo, hi](const auto& x) noexcept { return detail::clip<P>(x + offset, lo, hi); }, out, n, a);
+    }
+
+    /**
+     * Subtract `n` pairs `a[i] - b[i]` into `out`, clipped to `lo ... hi`.
+     */
+    template <nan_policy P = nan_policy::propagate, typename T>
+    inline std::enable_if_t<std::is_floating_point_v<T>>
+    subtract(const T* a, const T* b, T* out, std::size_t n, const T lo, const T hi) noexcept {
+        simd::transform([lo, hi](const auto& x, const auto& y) noexcept { return detail::clip<P>(x - y, lo, hi); }, out, n, a, b);
+    }
+
+    /**
+     * Multiply `n` pairs `a[i] * b[i]` into `out`, clipped to `lo ... hi`.
+     */
+    template <nan_policy P = nan_policy::propagate, typename T>
+    inline std::enable_if_t<std::is_floating_point_v<T>>
+    multiply(const T* a, const T* b, T* out, std::size_t n, const T lo, const T hi) noexcept {
+        simd::transform([lo, hi](const auto& x, const auto& y) noexcept { return detail::clip<P>(x * y, lo, hi); }, out, n, a, b);
+    }
+
+    /**
+     * Multiply `n` values by the constant `gain` into `out`, clipped to `lo ... hi`.
+     */
+    template <nan_policy P = nan_policy::propagate, typename T>
+    inline std::enable_if_t<std::is_floating_point_v<T>>
+    multiply(const T* a, const T gain, T* out, std::size_t n, const T lo, const T hi) noexcept {
+        simd::transform([gain, lo, hi](const auto& x) noexcept { return detail::clip<P>(x * gain, lo, hi); }, out, n, a);
+    }
+
+    // Saturating floating point type overloads, clipping to the limits of `S`
+
+    template <nan_policy P = nan_policy::propagate, typename S>
+    inline std::enable_if_t<detail::is_floating_type_v<S>>
+    clip(const S* in, S* out, std::size_t n) noexcept {
+        clip<P>(detail::values(in), detail::values(out), n, S::min_val, S::max_val);
+    }
+
+    template <nan_policy P = nan_policy::propagate, typename S>
+    inline std::enable_if_t<detail::is_floating_type_v<S>>
+    add(const S* a, const S* b, S* out, std::size_t n) noexcept {
+        add<P>(detail::values(a), detail::values(b), detail::values(out), n, S::min_val, S::max_val);
+    }
+
+    template <nan_policy P = nan_policy::propagate, typename S>
+    inline std::enable_if_t<detail::is_floating_type_v<S>>
+    add(const S* a, const typename S::value_type offset, S* out, std::size_t n) noexcept {
+        add<P>(detail::values(a), offset, detail::values(out), n, S::min_val, S::max_val);
+    }
+
+    template <nan_policy P = nan_policy::propagate, typename S>
+    inline std::enable_if_t<detail::is_floating_type_v<S>>
+    subtract(const S* a, const S* b, S* out, std::size_t n) noexcept {
+        subtract<P>(detail::values(a), detail::values(b), detail::values(out), n, S::min_val, S::max_val);
+    }
+
+    template <nan_policy P = nan_policy::propagate, typename S>
+    inline std::enable_if_t<detail::is_floating_type_v<S>>
+    multiply(const S* a, const S* b, S* out, std::size_t n) noexcept {
+        multiply<P>(detail::values(a), detail::values(b), detail::values(out), n, S::min_val, S::max_val);
+    }
+
+    template <nan_policy P = nan_policy::propagate, typename S>
+    inline std::enable_if_t<detail::is_floating_type_v<S>>
+    multiply(const S* a, const typename S::value_type gain, S* out, std::size_t n) noexcept {
+        multiply<P>(detail::values(a), gain, detail::values(out), n, S::min_val, S::max_val);
+    }
+
+    // Integral saturating type kernels. Types of up to 32 bits are vectorized, wider ones (and the
+    // inherently scalar `pow` and `sqrt`) apply the scalar operation per element.
+
+    /** `out[i] = a[i] + offset` */
+    template <typename S>
+    inline std::enable_if_t<detail::is_integral_type_v<S>>
+    add(const S* a, const typename S::value_type offset, S* out, std::size_t n) noexcept {
+        if constexpr (detail::has_wide_lanes_v<S>) {
+            using W = detail::wide_lane_t<typename S::value_type>;
+            const W w = offset;
+            detail::transform_wide([w](const auto& x) noexcept { return x + w; }, out, n, a);
+        } else {
+            for (std::size_t i = 0; i < n; ++i) out[i] = S::add(a[i], offset);
+        }
+    }
+
+    /** `out[i] = a[i] * gain` */
+    template <typename S>
+    inline std::enable_if_t<detail::is_integral_type_v<S>>
+    multiply(const S* a, const typename S::value_type gain, S* out, std::size_t n) noexcept {
+        if constexpr (detail::has_wide_lanes_v<S>) {
+            using W = detail::wide_lane_t<typename S::value_type>;
+            const W w = gain;
+            detail::transform_wide([w](const auto& x) noexcept { return x * w; }, out, n, a);
+        } else {
+            for (std::size_t i = 0; i < n; ++i) out[i] = S::multiply(a[i], gain);
+        }
+    }
+
+    /** `out[i] = -in[i]` */
+    template <typename S>
+    inline std::enable_if_t<detail::is_integral_type_v<S>>
+    negate(const S* in, S* out, std::size_t n) noexcept {
+        if constexpr (std::is_unsigned_v<typename S::value_type>) {
+            // Negation of a non negative value never exceeds the lowest limit of an unsigned type
+            for (std::size_t i = 0; i < n; ++i) out[i] = S{ S::min_val };
+        } else if constexpr (detail::has_wide_lanes_v<S>) {
+            detail::transform_wide([](const auto& x) noexcept { return -x; }, out, n, in);
+        } else {
+            for (std::size_t i = 0; i < n; ++i) out[i] = S::negate(in[i]);
+        }
+    }
+
+    /** `out[i] = |in[i]|` */
+    template <typename S>
+    inline std::enable_if_t<detail::is_integral_type_v<S>>
+    abs(const S* in, S* out, std::size_t n) noexcept {
+        if constexpr (detail::has_wide_lanes_v<S>) {
+            detail::transform_wide([](const auto& x) noexcept { return x < 0 ? -x : x; }, out, n, in);
+        } else {
+            for (std::size_t i = 0; i < n; ++i) out[i] = S::abs(in[i]);
+        }
+    }
+
+    /** `out[i] = |a[i] - b[i]|` */
+    template <typename S>
+    inline std::enable_if_t<detail::is_integral_type_v<S>>
+    abs_diff(const S* a, const S* b, S* out, std::size_t n) noexcept {
+        if constexpr (detail::has_wide_lanes_v<S>) {
+            detail::transform_wide([](const auto& x, const auto& y) noexcept { return x > y ? x - y : y - x; }, out, n, a, b);
+        } else {
+            for (std::size_t i = 0; i < n; ++i) out[i] = S::abs_diff(a[i], b[i]);
+        }
+    }
+
+    /** `out[i] = in[i] * 2^shift` */
+    template <typename S>
+    inline std::enable_if_t<detail::is_integral_type_v<S>>
+    shift_left(const S* in, S* out, std::size_t n, unsigned shift) noexcept {
+        if constexpr (detail::has_wide_lanes_v<S>) {
+            using W = detail::wide_lane_t<typename S::value_type>;
+            // Same limits as the scalar version: ceil(MIN / 2^shift) ... floor(MAX / 2^shift)
+            const unsigned bits = min(shift, static_cast<unsigned>(sizeof(typename S::value_type) * 8 + 1));
+            const auto lo = static_cast<W>(-(-static_cast<int64_t>(S::min_val) >> bits));
+            const auto hi = static_cast<W>(static_cast<int64_t>(S::max_val) >> bits);
+            const auto factor = static_cast<W>(static_cast<W>(1) << bits);
+            detail::transform_wide([lo, hi, factor](const auto& x) noexcept {
+                using V = std::decay_t<decltype(x)>;
+                return x > hi ? V{} + static_cast<W>(S::max_val) : (x < lo ? V{} + static_cast<W>(S::min_val) : x * factor);
+            }, out, n, in);
+        } else {
+            for (std::size_t i = 0; i < n; ++i) out[i] = S::shift_left(in[i], shift);
+        }
+    }
+
+    /** `out[i] = in[i]^2` */
+    template <typename S>
+    inline std::enable_if_t<detail::is_integral_type_v<S>>
+    square(const S* in, S* out, std::size_t n) noexcept {
+        if constexpr (detail::has_wide_lanes_v<S>) {
+            detail::transform_wide([](const auto& x) noexcept { return x * x; }, out, n, in);
+        } else {
+            for (std::size_t i = 0; i < n; ++i) out[i] = S::square(in[i]);
+        }
+    }
+
+    /** `out[i] = in[i]^exponent` */
+    template <typename S, typename E>
+    inline std::enable_if_t<detail::is_integral_type_v<S> && std::is_integral_v<E> && !std::is_same_v<E, bool>>
+    pow(const S* in, S* out, std::size_t n, const E exponent) noexcept {
+        for (std::size_t i = 0; i < n; ++i) out[i] = S::pow(in[i], exponent);
+    }
+
+    /** `out[i] = floor(sqrt(in[i]))` */
+    template <typename S>
+    inline std::enable_if_t<detail::is_integral_type_v<S>>
+    sqrt(const S* in, S* out, std::size_t n) noexcept {
+        for (std::size_t i = 0; i < n; ++i) out[i] = S::sqrt(in[i]);
+    }
+
+    /** `out[i] = in[i] + 1`, stopping at the upper limit */
+    template <typename S>
+    inline std::enable_if_t<detail::is_integral_type_v<S>>
+    increment(const S* in, S* out, std::size_t n) noexcept {
+        simd::transform([](const auto& x) noexcept { return x < S::max_val ? x + 1 : x; }, detail::values(out), n, detail::values(in));
+    }
+
+    /** `out[i] = in[i] - 1`, stopping at the lower limit */
+    template <typename S>
+    inline std::enable_if_t<detail::is_integral_type_v<S>>
+    decrement(const S* in, S* out, std::size_t n) noexcept {
+        simd::transform([](const auto& x) noexcept { return x > S::min_val ? x - 1 : x; }, detail::values(out), n, detail::values(in));
+    }
+
+    /**
+     * `out[i] = round(in[i] / 2^shift)`, saturated into `SOut`; typically a narrower type.
+     * Vectorized in lanes of the input type, the rounding bit is added after shifting so it cannot overflow.
+     */
+    template <typename SIn, typename SOut>
+    inline std::enable_if_t<detail::is_integral_type_v<SIn> && detail::is_integral_type_v<SOut>>
+    rounding_shift_right(const SIn* in, SOut* out, std::size_t n, unsigned shift) noexcept {
+        using TI = typename SIn::value_type;
+        using TO = typename SOut::value_type;
+        using W = wide_signed_t<TI, TO>;
+        constexpr W in_lowest = std::numeric_limits<TI>::lowest();
+        constexpr W in_max = std::numeric_limits<TI>::max();
+
+        if constexpr (static_cast<W>(SOut::max_val) < in_lowest || static_cast<W>(SOut::min_val) > in_max) {
+            // Output range lies completely outside the input range
+            for (std::size_t i = 0; i < n; ++i) out[i] = SOut::rounding_shift_right(in[i], shift);
+        } else {
+            // The output limits moved into the input range, so clipping can happen before converting lanes
+            const auto lo = static_cast<TI>(clamp(in_lowest, static_cast<W>(SOut::min_val), in_max));
+            const auto hi = static_cast<TI>(clamp(in_lowest, static_cast<W>(SOut::max_val), in_max));
+            if (shift == 0) {
+                simd::transform<simd::lanes<TI, TO>>([lo, hi](const auto& x) noexcept {
+                    return simd::convert<TO>(detail::clip<nan_policy::propagate>(x, lo, hi));
+                }, detail::values(out), n, detail::values(in));
+            } else if (shift > sizeof(TI) * 8) {
+                // Everything rounds to zero
+                const SOut zero = SOut::rounding_shift_right(TI{0}, 0);
+                for (std::size_t i = 0; i < n; ++i) out[i] = zero;
+            } else {
+                simd::transform<simd::lanes<TI, TO>>([shift, lo, hi](const auto& x) noexcept {
+                    const auto temp = x >> (shift - 1);
+                    return simd::convert<TO>(detail::clip<nan_policy::propagate>((temp >> 1) + (temp & 1), lo, hi));
+                }, detail::values(out), n, detail::values(in));
+            }
+        }
+    }
+} // namespace saturating::batch
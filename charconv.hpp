@@ -0,0 +1,251 @@
+/**@file
+ * @brief Saturating text parsing and formatting.
+ *
+ * `from_chars` parses straight into a `saturating::type`, clamping out of range input to the type
+ * limits instead of failing. `to_chars` formats the plain value. Neither allocates or throws.
+ * `parse_delimited` reads rows of delimited text (CSV and the like) into one typed column per field.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <charconv>
+#include <system_error>
+
+#include "./types.hpp"
+
+namespace saturating {
+    /**
+     * Result of a saturating parse. Mirrors `std::from_chars_result`, but additionally reports if the
+     * parsed value had to be clamped to fit the target type.
+     */
+    struct from_chars_result {
+        const char* ptr;
+        std::errc ec;
+        bool saturated;
+    };
+
+    namespace detail {
+        template <typename V>
+        using parse_wide_t = std::conditional_t<(sizeof(V) > sizeof(std::intmax_t)),
+                                                V,
+                                                std::conditional_t<std::is_signed_v<V>, std::intmax_t, std::uintmax_t>>;
+
+        /**
+         * Does an out of range floating point literal in `[first, last)` have a negative exponent (underflow)?
+         * Hexadecimal literals mark the exponent with `p`, `e` is one of their digits.
+         */
+        constexpr bool fp_underflows(const char* first, const char* last, std::chars_format fmt) noexcept {
+            const bool hex = fmt == std::chars_format::hex;
+            for (; first != last; ++first) {
+                if (hex ? (*first == 'p' || *first == 'P') : (*first == 'e' || *first == 'E')) {
+                    return (first + 1 != last) && first[1] == '-';
+                }
+            }
+            return false;
+        }
+
+        /** Is there a second sign after a leading `+`, which `std::from_chars` would accept once the `+` is skipped? */
+        constexpr bool double_sign(const char* first, const char* last) noexcept {
+            return last - first >= 2 && first[0] == '+' && (first[1] == '-' || first[1] == '+');
+        }
+    } // namespace detail
+
+    /**
+     * Parse an integral saturating type from `[first, last)`. A single leading `+` is accepted.
+     * Values outside `min_val ... max_val`, including those that do not fit any builtin integral,
+     * are clamped and flagged as `saturated`. `ec` is only set for input that is not a number.
+     * @param  first Start of the text
+     * @param  last  End of the text
+     * @param  out   Receives the parsed value, untouched on error
+     * @param  base  Numeric base, as for `std::from_chars`
+     * @return       Pointer past the parsed number, error code and saturation flag
+     */
+    template <typename S>
+    std::enable_if_t<is_type_v<S> && std::is_integral_v<typename S::value_type>, from_chars_result>
+    from_chars(const char* first, const char* last, S& out, int base = 10) noexcept {
+        using V = typename S::value_type;
+        using W = detail::parse_wide_t<V>;
+
+        if (detail::double_sign(first, last)) return { first, std::errc::invalid_argument, false };
+        // Errors point at `first` itself, like `std::from_chars`, not past the skipped `+`
+        const char* number = first != last && *first == '+' ? first + 1 : first;
+        const bool negative = number != last && *number == '-';
+
+        if constexpr (std::is_unsigned_v<V>) {
+            if (negative) {
+                // Unsigned parsing rejects a sign, so any (valid) negative number sits at the bottom
+                std::intmax_t temp = 0;
+                const auto res = std::from_chars(number, last, temp, base);
+                if (res.ec == std::errc::invalid_argument) return { first, res.ec, false };
+                out = S{ S::min_val };
+                return { res.ptr, std::errc{}, res.ec == std::errc::result_out_of_range || temp < 0 || S::min_val > 0 };
+            }
+        }
+
+        W temp = 0;
+        const auto res = std::from_chars(number, last, temp, base);
+        if (res.ec == std::errc::result_out_of_range) {
+            out = S{ negative ? S::min_val : S::max_val };
+            return { res.ptr, std::errc{}, true };
+        } else if (res.ec != std::errc{}) {
+            return { first, res.ec, false };
+        }
+
+        if (temp < static_cast<W>(S::min_val)) {
+            out = S{ S::min_val };
+            return { res.ptr, std::errc{}, true };
+        } else if (temp > static_cast<W>(S::max_val)) {
+            out = S{ S::max_val };
+            return { res.ptr, std::errc{}, true };
+        }
+        out = S{ static_cast<V>(temp) };
+        return { res.ptr, std::errc{}, false };
+    }
+
+    /**
+     * Parse a floating point saturating type from `[first, last)`. A single leading `+` is accepted.
+     * Overflowing literals clamp to the signed limit, underflowing ones to zero. NaN is rejected.
+     * @param  first Start of the text
+     * @param  last  End of the text
+     * @param  out   Receives the parsed value, untouched on error
+     * @param  fmt   Accepted formats, as for `std::from_chars`
+     * @return       Pointer past the parsed number, error code and saturation flag
+     */
+    template <typename S>
+    std::enable_if_t<is_type_v<S> && std::is_floating_point_v<typename S::value_type>, from_chars_result>
+    from_chars(const char* first, const char* last, S& out, std::chars_format fmt = std::chars_format::general) noexcept {
+        using V = typename S::value_type;
+
+        if (detail::double_sign(first, last)) return { first, std::errc::invalid_argument, false };
+        const char* number = first != last && *first == '+' ? first + 1 : first;
+        const bool negative = number != last && *number == '-';
+
+        V temp = 0;
+        const auto res = std::from_chars(number, last, temp, fmt);
+        if (res.ec == std::errc::result_out_of_range) {
+            if (detail::fp_underflows(number, res.ptr, fmt)) {
+                out = S{ static_cast<V>(clamp(S::min_val, V{0}, S::max_val)) };
+                return { res.ptr, std::errc{}, S::min_val > 0 || S::max_val < 0 };
+            }
+            out = S{ negative ? S::min_val : S::max_val };
+            return { res.ptr, std::errc{}, true };
+        } else if (res.ec != std::errc{} || temp != temp) {
+            return { first, res.ec != std::errc{} ? res.ec : std::errc::invalid_argument, false };
+        }
+
+        if (temp < S::min_val) {
+            out = S{ S::min_val };
+            return { res.ptr, std::errc{}, true };
+        } else if (temp > S::max_val) {
+            out = S{ S::max_val };
+            return { res.ptr, std::errc{}, true };
+        }
+        out = S{ temp };
+        return { res.ptr, std::errc{}, false };
+    }
+
+    /**
+     * Format an integral saturating type, see `std::to_chars`.
+     */
+    template <typename S>
+    std::enable_if_t<is_type_v<S> && std::is_integral_v<typename S::value_type>, std::to_chars_result>
+    to_chars(char* first, char* last, const S& val, int base = 10) noexcept {
+        return std::to_chars(first, last, static_cast<typename S::value_type>(val), base);
+    }
+
+    /**
+     * Format a floating point saturating type using the shortest round trip representation.
+     */
+    template <typename S>
+    std::enable_if_t<is_type_v<S> && std::is_floating_point_v<typename S::value_type>, std::to_chars_result>
+    to_chars(char* first, char* last, const S& val) noexcept {
+        return std::to_chars(first, last, static_cast<typename S::value_type>(val));
+    }
+
+    /**
+     * Format a floating point saturating type with explicit format and precision.
+     */
+    template <typename S>
+    std::enable_if_t<is_type_v<S> && std::is_floating_point_v<typename S::value_type>, std::to_chars_result>
+    to_chars(char* first, char* last, const S& val, std::chars_format fmt, int precision) noexcept {
+        return std::to_chars(first, last, static_cast<typename S::value_type>(val), fmt, precision);
+    }
+
+    /** Result of `parse_delimited`. */
+    struct parse_delimited_result {
+        const char* ptr;        //< Where parsing stopped, the start of the offending field on error
+        std::size_t rows;       //< Completely parsed rows
+        std::size_t saturated;  //< Number of fields that were clamped
+        std::errc ec;
+    };
+
+    /**
+     * Parse rows of `delimiter` separated numbers into one output column per field.
+     * Rows end with `\n` (or `\r\n`), the last row may omit it. Blanks around fields are skipped.
+     * Parsing stops after `max_rows` rows, at the end of the input, or at the first malformed field.
+     * @param  first     Start of the text
+     * @param  last      End of the text
+     * @param  delimiter Field separator, usually `,` or `\t`
+     * @param  max_rows  Capacity of every column
+     * @param  columns   Output arrays of saturating types, one per field
+     * @return           Stop position, parsed row and saturation counts, and error code
+     */
+    template <typename... S>
+    std::enable_if_t<(sizeof...(S) > 0) && (is_type_v<S> && ...), parse_delimited_result>
+    parse_delimited(const char* first, const char* last, char delimiter, std::size_t max_rows, S*... columns) noexcept {
+        parse_delimited_result result { first, 0, 0, std::errc{} };
+        const auto skip_blanks = [last, delimiter](const char* p) noexcept {
+            while (p != last && (*p == ' ' || (*p == '\t' && delimiter != '\t'))) ++p;
+            return p;
+        };
+
+        const char* p = first;
+        while (result.rows < max_rows && p != last) {
+            // Tolerate blank lines between rows
+            if (*p == '\n' || *p == '\r') { ++p; continue; }
+
+            std::size_t field = 0;
+            const auto parse_field = [&](auto* column) noexcept {
+                p = skip_blanks(p);
+                const auto res = from_chars(p, last, column[result.rows]);
+                if (res.ec != std::errc{}) {
+                    result.ec = res.ec;
+                    return false;
+                }
+                result.saturated += res.saturated;
+                p = skip_blanks(res.ptr);
+
+                if (++field < sizeof...(S)) {
+                    if (p == last || *p != delimiter) {
+                        result.ec = std::errc::invalid_argument;
+                        return false;
+                    }
+                    ++p;
+                } else {
+                    if (p != last && *p == '\r') ++p;
+                    if (p != last) {
+                        if (*p != '\n') {
+                            result.ec = std::errc::invalid_argument;
+                            return false;
+                        }
+                        ++p;
+                    }
+                }
+                return true;
+            };
+
+            if (!(parse_field(columns) && ...)) {
+                result.ptr = p;
+                return result;
+            }
+            ++result.rows;
+        }
+        result.ptr = p;
+        return result;
+    }
+} // namespace saturating
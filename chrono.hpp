@@ -0,0 +1,374 @@
+/**@file
+ * @brief Saturating `std::chrono` style durations and time point arithmetic.
+ *
+ * `std::chrono` arithmetic overflows silently (it is undefined for the signed representations of
+ * the standard clocks), so a deadline like `now + timeout` breaks for "infinite" timeouts. A
+ * `saturating::duration` behaves like `std::chrono::duration`, but arithmetic, unit conversions and
+ * time points shifted by it stop at the limits of the representation instead.
+ *
+ * Durations hold a `saturating::type` count and convert implicitly from and to `std::chrono`
+ * durations. Arithmetic uses the overflow builtins, so the common case costs one extra branch over
+ * plain `std::chrono` math, and conversion factors are resolved at compile time like they are there.
+ * Representations are integrals of up to 64 bits; floating point durations don't overflow anyway.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <ratio>
+#include <type_traits>
+
+#include "./types.hpp"
+
+namespace saturating {
+    template <typename Rep, typename Period = std::ratio<1>>
+    class duration;
+
+    namespace detail::chrono {
+        /** Plain representation and period of a `saturating::duration` or `std::chrono::duration`. */
+        template <typename D>
+        struct traits {
+            static constexpr bool is_duration = false;
+            static constexpr bool is_saturating = false;
+        };
+
+        template <typename Rep, typename Period>
+        struct traits<std::chrono::duration<Rep, Period>> {
+            static constexpr bool is_duration = std::is_integral_v<Rep>;
+            static constexpr bool is_saturating = false;
+            using rep = Rep;
+            using period = typename Period::type;
+        };
+
+        template <typename Rep, typename Period>
+        struct traits<duration<Rep, Period>> {
+            static constexpr bool is_duration = true;
+            static constexpr bool is_saturating = true;
+            using rep = Rep;
+            using period = typename Period::type;
+        };
+
+        template <typename D>
+        constexpr bool is_duration_v = traits<D>::is_duration;
+
+        /** Both are durations, at least one saturating: the operators below apply instead of those of `std::chrono`. */
+        template <typename D1, typename D2>
+        constexpr bool saturates_v = is_duration_v<D1> && is_duration_v<D2> && (traits<D1>::is_saturating || traits<D2>::is_saturating);
+
+        /** Saturating duration both `D1` and `D2` convert to without losing precision, like `std::common_type`. */
+        template <typename D1, typename D2>
+        using common_t = duration<std::common_type_t<typename traits<D1>::rep, typename traits<D2>::rep>,
+                                  typename std::common_type_t<std::chrono::duration<typename traits<D1>::rep, typename traits<D1>::period>,
+                                                              std::chrono::duration<typename traits<D2>::rep, typename traits<D2>::period>>::period>;
+
+        /** Integral holding any count multiplied by any factor between the periods of durations. */
+        using wide_t = wide_signed_t<intmax_t>;
+
+        /** `val` converted to the integral `To`, saturating at its limits. */
+        template <typename To, typename From>
+        constexpr To saturate_cast(const From val) noexcept {
+            To result {};
+            if (!__builtin_add_overflow(val, 0, &result)) return result;
+            // Only negative values can fall below the range, so `<=` also works for unsigned `From`
+            return val <= From{} ? std::numeric_limits<To>::lowest() : std::numeric_limits<To>::max();
+        }
+
+        template <typename T>
+        constexpr T add(const T a, const T b) noexcept {
+            T result {};
+            if (!__builtin_add_overflow(a, b, &result)) return result;
+            if constexpr (std::is_unsigned_v<T>) {
+                return std::numeric_limits<T>::max();
+            } else {
+                return b < 0 ? std::numeric_limits<T>::lowest() : std::numeric_limits<T>::max();
+            }
+        }
+
+        template <typename T>
+        constexpr T subtract(const T a, const T b) noexcept {
+            T result {};
+            if (!__builtin_sub_overflow(a, b, &result)) return result;
+            if constexpr (std::is_unsigned_v<T>) {
+                return std::numeric_limits<T>::lowest();
+            } else {
+                return b < 0 ? std::numeric_limits<T>::max() : std::numeric_limits<T>::lowest();
+            }
+        }
+
+        template <typename T, typename U>
+        constexpr T multiply(const T a, const U b) noexcept {
+            T result {};
+            if (!__builtin_mul_overflow(a, b, &result)) return result;
+            return (a < T{}) != (b < U{}) ? std::numeric_limits<T>::lowest() : std::numeric_limits<T>::max();
+        }
+
+        /** `a / b` truncated like integral division, division by zero saturating towards the sign of `a`. */
+        template <typename T>
+        constexpr T divide(const T a, const T b) noexcept {
+            if (b == 0) return a > 0 ? std::numeric_limits<T>::max() : (a < 0 ? std::numeric_limits<T>::lowest() : T{});
+            if constexpr (std::is_signed_v<T>) {
+                if (b == -1) return a == std::numeric_limits<T>::lowest() ? std::numeric_limits<T>::max() : -a;
+            }
+            return a / b;
+        }
+
+        /** `a % b`, zero for a zero `b`. */
+        template <typename T>
+        constexpr T modulo(const T a, const T b) noexcept {
+            if constexpr (std::is_signed_v<T>) {
+                if (b == -1) return 0;
+            }
+            return b == 0 ? T{} : a % b;
+        }
+
+        /**
+         * A count in units of `From` converted to units of `To`, truncated towards zero like
+         * `std::chrono::duration_cast` and saturated to the limits of `ToRep`.
+         */
+        template <typename ToRep, typename To, typename From, typename Rep>
+        constexpr ToRep convert(const Rep count) noexcept {
+            using factor = std::ratio_divide<From, To>;
+            if constexpr (factor::num == 1 && factor::den == 1) {
+                return saturate_cast<ToRep>(count);
+            } else if constexpr (factor::den == 1) {
+                // To a finer unit, the overflow check of the multiplication is the only cost
+                ToRep result {};
+                if (!__builtin_mul_overflow(count, factor::num, &result)) return result;
+                return count <= Rep{} ? std::numeric_limits<ToRep>::lowest() : std::numeric_limits<ToRep>::max();
+            } else if constexpr (factor::num == 1) {
+                // To a coarser unit, never overflows before the final narrowing
+                return saturate_cast<ToRep>(count / factor::den);
+            } else {
+                intmax_t product = 0;
+                if (!__builtin_mul_overflow(count, factor::num, &product)) return saturate_cast<ToRep>(product / factor::den);
+                return saturate_cast<ToRep>(static_cast<wide_t>(count) * factor::num / factor::den);
+            }
+        }
+
+        /** Count of duration `d` as an exact wide integral in units of `To`, which must divide its period. */
+        template <typename To, typename D>
+        constexpr wide_t exact_count(const D& d) noexcept {
+            using factor = std::ratio_divide<typename traits<D>::period, To>;
+            static_assert(factor::den == 1, "Period not a multiple of the common period");
+            return static_cast<wide_t>(static_cast<typename traits<D>::rep>(d.count())) * factor::num;
+        }
+    } // namespace detail::chrono
+
+    /**
+     * Duration of `Rep` ticks of `Period` seconds, saturating at the limits of `Rep`.
+     * Mirrors `std::chrono::duration`, but converting from durations with a finer period is allowed
+     * implicitly only when exact in units, as with `std::chrono`; use `duration_cast` for the others.
+     */
+    template <typename Rep, typename Period>
+    class duration {
+        static_assert(std::is_integral_v<Rep> && sizeof(Rep) <= sizeof(intmax_t), "Saturating durations need integral representations of up to 64 bits");
+
+        /** Durations of `Period2` convert to this one without truncation. */
+        template <typename Period2>
+        static constexpr bool exact_v = std::ratio_divide<Period2, Period>::den == 1;
+
+    public:
+        using rep = type<Rep>;
+        using period = typename Period::type;
+
+        constexpr duration() noexcept = default;
+
+        /** Duration of `count` ticks, `count` clamped to the limits of `Rep`. */
+        template <typename Rep2, typename = std::enable_if_t<std::is_integral_v<Rep2> && !is_type_v<Rep2>>>
+        constexpr explicit duration(const Rep2 count) noexcept : ticks{ detail::chrono::saturate_cast<Rep>(count) } {}
+
+        constexpr explicit duration(const rep count) noexcept : ticks{ count } {}
+
+        template <typename Rep2, typename Period2, typename = std::enable_if_t<exact_v<Period2>>>
+        constexpr duration(const duration<Rep2, Period2>& d) noexcept
+            : ticks{ detail::chrono::convert<Rep, period, Period2>(static_cast<Rep2>(d.count())) } {}
+
+        template <typename Rep2, typename Period2, typename = std::enable_if_t<std::is_integral_v<Rep2> && exact_v<Period2>>>
+        constexpr duration(const std::chrono::duration<Rep2, Period2>& d) noexcept
+            : ticks{ detail::chrono::convert<Rep, period, Period2>(d.count()) } {}
+
+        /** The same duration as `std::chrono::duration`, always exact. */
+        constexpr operator std::chrono::duration<Rep, Period>() const noexcept {
+            return std::chrono::duration<Rep, Period>{ static_cast<Rep>(ticks) };
+        }
+
+        constexpr rep count() const noexcept { return ticks; }
+
+        static constexpr duration zero() noexcept { return duration{ Rep{} }; }
+        static constexpr duration min() noexcept { return duration{ std::numeric_limits<Rep>::lowest() }; }
+        static constexpr duration max() noexcept { return duration{ std::numeric_limits<Rep>::max() }; }
+
+        constexpr duration operator+() const noexcept { return *this; }
+        constexpr duration operator-() const noexcept { return duration{ detail::chrono::subtract(Rep{}, value()) }; }
+
+        constexpr duration& operator++() noexcept { ++ticks; return *this; }
+        constexpr duration& operator--() noexcept { --ticks; return *this; }
+        constexpr duration operator++(int) noexcept { const duration old = *this; ++ticks; return old; }
+        constexpr duration operator--(int) noexcept { const duration old = *this; --ticks; return old; }
+
+        constexpr duration& operator+=(const duration& d) noexcept { ticks = rep{ detail::chrono::add(value(), d.value()) }; return *this; }
+        constexpr duration& operator-=(const duration& d) noexcept { ticks = rep{ detail::chrono::subtract(value(), d.value()) }; return *this; }
+        constexpr duration& operator*=(const Rep k) noexcept { ticks = rep{ detail::chrono::multiply(value(), k) }; return *this; }
+        constexpr duration& operator/=(const Rep k) noexcept { ticks = rep{ detail::chrono::divide(value(), k) }; return *this; }
+        constexpr duration& operator%=(const Rep k) noexcept { ticks = rep{ detail::chrono::modulo(value(), k) }; return *this; }
+        constexpr duration& operator%=(const duration& d) noexcept { return *this %= d.value(); }
+
+    private:
+        constexpr Rep value() const noexcept { return static_cast<Rep>(ticks); }
+
+        rep ticks;
+    };
+
+    using nanoseconds  = duration<int64_t, std::nano>;
+    using microseconds = duration<int64_t, std::micro>;
+    using milliseconds = duration<int64_t, std::milli>;
+    using seconds      = duration<int64_t>;
+    using minutes      = duration<int64_t, std::ratio<60>>;
+    using hours        = duration<int64_t, std::ratio<3600>>;
+
+    /**
+     * Convert a duration to `ToDuration` (a `saturating::duration` or integral `std::chrono::duration`),
+     * truncating towards zero like `std::chrono::duration_cast` but saturating instead of overflowing.
+     */
+    template <typename ToDuration, typename D>
+    constexpr std::enable_if_t<detail::chrono::is_duration_v<ToDuration> && detail::chrono::is_duration_v<D>, ToDuration>
+    duration_cast(const D& d) noexcept {
+        using to = detail::chrono::traits<ToDuration>;
+        using from = detail::chrono::traits<D>;
+        return ToDuration{ detail::chrono::convert<typename to::rep, typename to::period, typename from::period>(
+                                static_cast<typename from::rep>(d.count())) };
+    }
+
+    // Arithmetic between durations, at least one of them saturating, in their common duration type
+
+    template <typename D1, typename D2>
+    constexpr std::enable_if_t<detail::chrono::saturates_v<D1, D2>, detail::chrono::common_t<D1, D2>>
+    operator+(const D1& a, const D2& b) noexcept {
+        using CD = detail::chrono::common_t<D1, D2>;
+        return CD{ CD{ a } += CD{ b } };
+    }
+
+    template <typename D1, typename D2>
+    constexpr std::enable_if_t<detail::chrono::saturates_v<D1, D2>, detail::chrono::common_t<D1, D2>>
+    operator-(const D1& a, const D2& b) noexcept {
+        using CD = detail::chrono::common_t<D1, D2>;
+        return CD{ CD{ a } -= CD{ b } };
+    }
+
+    /** Number of times `b` fits in `a`, truncated; division by zero saturates. */
+    template <typename D1, typename D2>
+    constexpr std::enable_if_t<detail::chrono::saturates_v<D1, D2>, typename detail::chrono::common_t<D1, D2>::rep>
+    operator/(const D1& a, const D2& b) noexcept {
+        using CD = detail::chrono::common_t<D1, D2>;
+        using R = typename detail::chrono::traits<CD>::rep;
+        return typename CD::rep{ detail::chrono::divide(static_cast<R>(CD{ a }.count()), static_cast<R>(CD{ b }.count())) };
+    }
+
+    template <typename D1, typename D2>
+    constexpr std::enable_if_t<detail::chrono::saturates_v<D1, D2>, detail::chrono::common_t<D1, D2>>
+    operator%(const D1& a, const D2& b) noexcept {
+        using CD = detail::chrono::common_t<D1, D2>;
+        return CD{ CD{ a } %= CD{ b } };
+    }
+
+    template <typename Rep, typename Period>
+    constexpr duration<Rep, Period> operator*(duration<Rep, Period> d, const Rep k) noexcept { return d *= k; }
+
+    template <typename Rep, typename Period>
+    constexpr duration<Rep, Period> operator*(const Rep k, duration<Rep, Period> d) noexcept { return d *= k; }
+
+    template <typename Rep, typename Period>
+    constexpr duration<Rep, Period> operator/(duration<Rep, Period> d, const Rep k) noexcept { return d /= k; }
+
+    template <typename Rep, typename Period>
+    constexpr duration<Rep, Period> operator%(duration<Rep, Period> d, const Rep k) noexcept { return d %= k; }
+
+    // Comparisons are exact, also near the limits where converting to the common type would saturate
+
+    template <typename D1, typename D2>
+    constexpr std::enable_if_t<detail::chrono::saturates_v<D1, D2>, bool>
+    operator==(const D1& a, const D2& b) noexcept {
+        using P = typename detail::chrono::common_t<D1, D2>::period;
+        return detail::chrono::exact_count<P>(a) == detail::chrono::exact_count<P>(b);
+    }
+
+    template <typename D1, typename D2>
+    constexpr std::enable_if_t<detail::chrono::saturates_v<D1, D2>, bool>
+    operator<(const D1& a, const D2& b) noexcept {
+        using P = typename detail::chrono::common_t<D1, D2>::period;
+        return detail::chrono::exact_count<P>(a) < detail::chrono::exact_count<P>(b);
+    }
+
+    template <typename D1, typename D2>
+    constexpr std::enable_if_t<detail::chrono::saturates_v<D1, D2>, bool>
+    operator!=(const D1& a, const D2& b) noexcept { return !(a == b); }
+
+    template <typename D1, typename D2>
+    constexpr std::enable_if_t<detail::chrono::saturates_v<D1, D2>, bool>
+    operator>(const D1& a, const D2& b) noexcept { return b < a; }
+
+    template <typename D1, typename D2>
+    constexpr std::enable_if_t<detail::chrono::saturates_v<D1, D2>, bool>
+    operator<=(const D1& a, const D2& b) noexcept { return !(b < a); }
+
+    template <typename D1, typename D2>
+    constexpr std::enable_if_t<detail::chrono::saturates_v<D1, D2>, bool>
+    operator>=(const D1& a, const D2& b) noexcept { return !(a < b); }
+
+    // Time points shifted by durations. A saturating duration operand makes the `std::chrono`
+    // operators saturate too, `add` and `subtract` do the same for plain durations.
+
+    /**
+     * `tp + d`, saturating at the limits of the time point, in the common duration type like `std::chrono`.
+     * @code
+     *     const auto deadline = saturating::add(std::chrono::steady_clock::now(), timeout);
+     * @endcode
+     */
+    template <typename Clock, typename Duration, typename D>
+    constexpr std::enable_if_t<detail::chrono::is_duration_v<D>,
+                               std::chrono::time_point<Clock, std::chrono::duration<typename detail::chrono::common_t<Duration, D>::rep::value_type,
+                                                                                    typename detail::chrono::common_t<Duration, D>::period>>>
+    add(const std::chrono::time_point<Clock, Duration>& tp, const D& d) noexcept {
+        using CD = detail::chrono::common_t<Duration, D>;
+        return std::chrono::time_point<Clock, std::chrono::duration<typename CD::rep::value_type, typename CD::period>>{
+            CD{ tp.time_since_epoch() } += CD{ d } };
+    }
+
+    /** `tp - d`, see `add` */
+    template <typename Clock, typename Duration, typename D>
+    constexpr std::enable_if_t<detail::chrono::is_duration_v<D>,
+                               std::chrono::time_point<Clock, std::chrono::duration<typename detail::chrono::common_t<Duration, D>::rep::value_type,
+                                                                                    typename detail::chrono::common_t<Duration, D>::period>>>
+    subtract(const std::chrono::time_point<Clock, Duration>& tp, const D& d) noexcept {
+        using CD = detail::chrono::common_t<Duration, D>;
+        return std::chrono::time_point<Clock, std::chrono::duration<typename CD::rep::value_type, typename CD::period>>{
+            CD{ tp.time_since_epoch() } -= CD{ d } };
+    }
+
+    /** Saturating duration `a - b` between time points of one clock. */
+    template <typename Clock, typename Duration1, typename Duration2>
+    constexpr detail::chrono::common_t<Duration1, Duration2>
+    subtract(const std::chrono::time_point<Clock, Duration1>& a, const std::chrono::time_point<Clock, Duration2>& b) noexcept {
+        using CD = detail::chrono::common_t<Duration1, Duration2>;
+        return CD{ a.time_since_epoch() } -= CD{ b.time_since_epoch() };
+    }
+
+    template <typename Clock, typename Duration, typename Rep, typename Period>
+    constexpr auto operator+(const std::chrono::time_point<Clock, Duration>& tp, const duration<Rep, Period>& d) noexcept { return add(tp, d); }
+
+    template <typename Clock, typename Duration, typename Rep, typename Period>
+    constexpr auto operator+(const duration<Rep, Period>& d, const std::chrono::time_point<Clock, Duration>& tp) noexcept { return add(tp, d); }
+
+    template <typename Clock, typename Duration, typename Rep, typename Period>
+    constexpr auto operator-(const std::chrono::time_point<Clock, Duration>& tp, const duration<Rep, Period>& d) noexcept { return subtract(tp, d); }
+
+    /** `Clock::now() + timeout`, saturating: the largest timeout is a deadline that never passes. */
+    template <typename Clock = std::chrono::steady_clock, typename D>
+    std::enable_if_t<detail::chrono::is_duration_v<D>, decltype(add(Clock::now(), std::declval<const D&>()))>
+    deadline(const D& timeout) noexcept {
+        return add(Clock::now(), timeout);
+    }
+} // namespace saturating
@@ -0,0 +1,345 @@
+/**@file
+ * @brief Saturating types with limits chosen at runtime.
+ *
+ * `saturating::type` fixes its limits at compile time. For limits that come from configuration,
+ * `bounds<T>` holds them at runtime and `dynamic_type<T>` pairs a value with its bounds, offering
+ * the operators of `saturating::type`. As there, results take the limits of the left hand operand.
+ * Results are those of the exact operation clamped to the bounds, integral division rounds like
+ * `saturating::divide`.
+ *
+ * For arrays, keep the plain values and one `bounds` object: the `batch` kernels below broadcast
+ * the bounds into vector registers once and run as fast as their compile time counterparts.
+ * Floating point bounds need not be integral, solving the integral limits of floating point
+ * `saturating::type`.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+#include "./types.hpp"
+#include "./simd.hpp"
+#include "./batch.hpp"
+
+namespace saturating {
+    template <typename T>
+    class dynamic_type;
+
+    /** Trait detecting any `saturating::dynamic_type` instantiation. */
+    template <typename T>
+    struct is_dynamic_type : std::false_type {};
+
+    template <typename T>
+    struct is_dynamic_type<dynamic_type<T>> : std::true_type {};
+
+    template <typename T>
+    constexpr bool is_dynamic_type_v = is_dynamic_type<std::remove_cv_t<std::remove_reference_t<T>>>::value;
+
+    namespace detail::dynamic {
+        /** Plain value of an arithmetic, `type` or `dynamic_type` operand. */
+        template <typename U>
+        constexpr auto plain(const U& val) noexcept {
+            if constexpr (is_type_v<U> || is_dynamic_type_v<U>) {
+                return static_cast<typename U::value_type>(val);
+            } else {
+                return val;
+            }
+        }
+
+        template <typename U>
+        using plain_t = decltype(plain(std::declval<U>()));
+    } // namespace detail::dynamic
+
+    /** Limits `lo ... hi` of a saturating value, `lo <= hi`. */
+    template <typename T>
+    struct bounds {
+        static_assert(std::is_arithmetic_v<T> && !is_type_v<T>, "Bounds hold plain arithmetic limits");
+
+        using value_type = T;
+
+        T lo = std::numeric_limits<T>::lowest();
+        T hi = std::numeric_limits<T>::max();
+
+        /** Limits of the saturating type `S`. */
+        template <typename S>
+        static constexpr std::enable_if_t<is_type_v<S>, bounds> of() noexcept { return { S::min_val, S::max_val }; }
+
+        /** `val` clamped to `lo ... hi`, floating point values rounded for integral `T`. */
+        template <typename U>
+        constexpr T __attribute__((const)) clamp(const U val) const noexcept {
+            if constexpr (std::is_integral_v<T> && std::is_floating_point_v<U>) {
+                // `round` saturates to an integral of the signedness of `T`, so the comparisons are exact
+                const auto rounded = round<T>(val);
+                return rounded < lo ? lo : (rounded > hi ? hi : static_cast<T>(rounded));
+            } else if constexpr (std::is_integral_v<T> && std::is_integral_v<U>) {
+                using W = wide_signed_t<T, U>;
+                const W w = val;
+                return w < static_cast<W>(lo) ? lo : (w > static_cast<W>(hi) ? hi : static_cast<T>(w));
+            } else {
+                return val < lo ? lo : (val > hi ? hi : static_cast<T>(val));
+            }
+        }
+
+        constexpr bool contains(const T val) const noexcept { return val >= lo && val <= hi; }
+    };
+
+    /**
+     * Value of `T` saturating at the runtime limits of its `bounds`.
+     * @code
+     *     const saturating::bounds<int16_t> volume { 0, config.max_volume };
+     *     saturating::dynamic_type<int16_t> v { 0, volume };
+     *     v += step;     // Stops at config.max_volume
+     * @endcode
+     */
+    template <typename T>
+    class dynamic_type {
+    public:
+        using value_type = T;
+        using bounds_type = bounds<T>;
+
+        /** Zero, or the limit nearest to it, within `limits` (default the limits of `T`). */
+        constexpr explicit dynamic_type(const bounds_type& limits = {}) noexcept : value{ limits.clamp(T{}) }, limits_{ limits } {}
+
+        /** `val` clamped to `limits`. */
+        template <typename U, typename = std::enable_if_t<std::is_arithmetic_v<detail::dynamic::plain_t<U>>>>
+        constexpr dynamic_type(const U& val, const bounds_type& limits) noexcept
+            : value{ limits.clamp(detail::dynamic::plain(val)) }, limits_{ limits } {}
+
+        /**
+         * Same value and limits as a `saturating::type` of the same value type, others do not convert.
+         * Limits of floating point types are `int`, so only the value type is compared.
+         */
+        template <typename T2, auto MIN, auto MAX, typename = std::enable_if_t<std::is_same_v<T, std::decay_t<T2>>>>
+        constexpr dynamic_type(const type<T2, MIN, MAX>& val) noexcept
+            : value{ static_cast<T>(val) }, limits_{ static_cast<T>(MIN), static_cast<T>(MAX) } {}
+
+        constexpr operator const T&() const noexcept { return value; }
+
+        constexpr const bounds_type& limits() const noexcept { return limits_; }
+
+        /** The value clamped into saturating type `S`. */
+        template <typename S>
+        constexpr std::enable_if_t<is_type_v<S>, S> to() const noexcept { return S::from(value); }
+
+        /** New value `val` clamped to the limits. Assigning a `dynamic_type` copies its limits as well. */
+        template <typename U>
+        constexpr dynamic_type& operator=(const U& val) noexcept { value = limits_.clamp(detail::dynamic::plain(val)); return *this; }
+
+        template <typename U> constexpr dynamic_type& operator+=(const U& other) noexcept { value = add(value, detail::dynamic::plain(other)); return *this; }
+        template <typename U> constexpr dynamic_type& operator-=(const U& other) noexcept { value = subtract(value, detail::dynamic::plain(other)); return *this; }
+        template <typename U> constexpr dynamic_type& operator*=(const U& other) noexcept { value = multiply(value, detail::dynamic::plain(other)); return *this; }
+        template <typename U> constexpr dynamic_type& operator/=(const U& other) noexcept { value = divide(value, detail::dynamic::plain(other)); return *this; }
+        template <typename U> constexpr dynamic_type& operator%=(const U& other) noexcept { value = modulo(value, detail::dynamic::plain(other)); return *this; }
+
+        template <typename U>
+        constexpr std::enable_if_t<std::is_integral_v<T> && std::is_integral_v<U>, dynamic_type&>
+        operator<<=(const U& shift) noexcept {
+            value = limits_.clamp(saturating::shift_left<T>(value, static_cast<unsigned>(shift)));
+            return *this;
+        }
+
+        template <typename U> constexpr dynamic_type __attribute__((pure)) operator+(const U& other) const noexcept { return dynamic_type{ *this } += other; }
+        template <typename U> constexpr dynamic_type __attribute__((pure)) operator-(const U& other) const noexcept { return dynamic_type{ *this } -= other; }
+        template <typename U> constexpr dynamic_type __attribute__((pure)) operator*(const U& other) const noexcept { return dynamic_type{ *this } *= other; }
+        template <typename U> constexpr dynamic_type __attribute__((pure)) operator/(const U& other) const noexcept { return dynamic_type{ *this } /= other; }
+        template <typename U> constexpr dynamic_type __attribute__((pure)) operator%(const U& other) const noexcept { return dynamic_type{ *this } %= other; }
+        template <typename U> constexpr dynamic_type __attribute__((pure)) operator<<(const U& shift) const noexcept { return dynamic_type{ *this } <<= shift; }
+
+        constexpr dynamic_type __attribute__((pure)) operator-() const noexcept { return dynamic_type{ *this } = subtract(T{}, value); }
+
+        constexpr dynamic_type& operator++() noexcept { if (value < limits_.hi) value = limits_.clamp(value + T{1}); return *this; }
+        constexpr dynamic_type& operator--() noexcept { if (value > limits_.lo) value = limits_.clamp(value - T{1}); return *this; }
+        constexpr dynamic_type operator++(int) noexcept { const dynamic_type temp { *this }; ++*this; return temp; }
+        constexpr dynamic_type operator--(int) noexcept { const dynamic_type temp { *this }; --*this; return temp; }
+
+    private:
+        // Overflow of `T` is detected with the builtins (computing the exact result), saturated in the
+        // direction of the overflow and then clamped to the limits. Floating point results need no overflow check.
+
+        template <typename U>
+        constexpr T add(const T a, const U b) const noexcept {
+            if constexpr (std::is_integral_v<T> && std::is_integral_v<U>) {
+                T result {};
+                if (__builtin_add_overflow(a, b, &result)) return b > 0 ? limits_.hi : limits_.lo;
+                return limits_.clamp(result);
+            } else {
+                return limits_.clamp(a + b);
+            }
+        }
+
+        template <typename U>
+        constexpr T subtract(const T a, const U b) const noexcept {
+            if constexpr (std::is_integral_v<T> && std::is_integral_v<U>) {
+                T result {};
+                if (__builtin_sub_overflow(a, b, &result)) return b > 0 ? limits_.lo : limits_.hi;
+                return limits_.clamp(result);
+            } else {
+                return limits_.clamp(a - b);
+            }
+        }
+
+        template <typename U>
+        constexpr T multiply(const T a, const U b) const noexcept {
+            if constexpr (std::is_integral_v<T> && std::is_integral_v<U>) {
+                T result {};
+                if (__builtin_mul_overflow(a, b, &result)) return (a < T{}) == (b < U{}) ? limits_.hi : limits_.lo;
+                return limits_.clamp(result);
+            } else {
+                return limits_.clamp(a * b);
+            }
+        }
+
+        template <typename U>
+        constexpr T divide(const T a, const U b) const noexcept {
+            if constexpr (std::is_integral_v<T> && std::is_integral_v<U>) {
+                return limits_.clamp(saturating::divide<T>(a, b));
+            } else {
+                return limits_.clamp(a / b);
+            }
+        }
+
+        // Integral remainders on the magnitudes, so mixed signedness does not convert the divisor (`5u % -2` is 1)
+        // and `lowest % -1` is zero. A zero divisor leaves `a`.
+        template <typename U>
+        constexpr T modulo(const T a, const U b) const noexcept {
+            if constexpr (std::is_integral_v<T> && std::is_integral_v<U>) {
+                return limits_.clamp(saturating::modulo<T>(a, b));
+            } else {
+                using C = std::common_type_t<T, U>;
+                return b == U{} ? a : limits_.clamp(std::fmod(static_cast<C>(a), static_cast<C>(b)));
+            }
+        }
+
+        T value;
+        bounds_type limits_;
+    };
+
+    // Arithmetic left hand operands, the result takes the limits of the right hand one
+
+    template <typename U, typename T>
+    constexpr std::enable_if_t<std::is_arithmetic_v<U> && !is_type_v<U>, dynamic_type<T>>
+    operator+(const U& a, const dynamic_type<T>& b) noexcept { return dynamic_type<T>{ b } += a; }
+
+    template <typename U, typename T>
+    constexpr std::enable_if_t<std::is_arithmetic_v<U> && !is_type_v<U>, dynamic_type<T>>
+    operator-(const U& a, const dynamic_type<T>& b) noexcept {
+        dynamic_type<T> result { b.limits() };
+        if constexpr (std::is_integral_v<U> && std::is_integral_v<T>) {
+            // `a` may lie outside the limits (and the range of `T`), subtract from it unclamped
+            using W = wide_signed_t<T, U>;
+            const W diff = static_cast<W>(a) - static_cast<W>(static_cast<T>(b));
+            return result = diff < static_cast<W>(b.limits().lo) ? b.limits().lo
+                            : (diff > static_cast<W>(b.limits().hi) ? b.limits().hi : static_cast<T>(diff));
+        } else {
+            return result = a - static_cast<T>(b);
+        }
+    }
+
+    template <typename U, typename T>
+    constexpr std::enable_if_t<std::is_arithmetic_v<U> && !is_type_v<U>, dynamic_type<T>>
+    operator*(const U& a, const dynamic_type<T>& b) noexcept { return dynamic_type<T>{ b } *= a; }
+
+    namespace batch {
+        namespace detail {
+            /** Signed lane type twice as wide as `T`, holding any difference of values of `T`. */
+            template <typename T>
+            using signed_wide_lane_t = simd::mask_lane_t<wide_lane_t<T>>;
+
+            /**
+             * `transform_wide` with runtime limits: `f` is applied to the inputs widened to `W` and the
+             * result is clipped to `limits` before narrowing back to `T`.
+             */
+            template <typename W, typename T, typename F, typename... In>
+            inline void transform_bounded(F&& f, T* out, std::size_t n, const bounds<T>& limits, const In*... in) noexcept {
+                const W lo = limits.lo;
+                const W hi = limits.hi;
+                simd::transform<simd::lanes<W>>([&f, lo, hi](const auto&... x) noexcept {
+                    return simd::convert<T>(clip<nan_policy::propagate>(f(simd::convert<W>(x)...), lo, hi));
+                }, out, n, in...);
+            }
+
+            /** Plain integrals of up to 32 bits are processed in lanes of double width. */
+            template <typename T>
+            constexpr bool has_plain_wide_lanes_v = std::is_integral_v<T> && sizeof(T) <= sizeof(int32_t);
+        } // namespace detail
+
+        // Kernels with runtime limits. Floating point values use the kernels of `batch.hpp`, integrals of
+        // up to 32 bits are vectorized in wide lanes, wider ones apply the `dynamic_type` operation per element.
+
+        /** `out[i] = clamp(in[i], limits)` */
+        template <nan_policy P = nan_policy::propagate, typename T>
+        inline void clip(const T* in, T* out, std::size_t n, const bounds<T>& limits) noexcept {
+            clip<P>(in, out, n, limits.lo, limits.hi);
+        }
+
+        /** `out[i] = a[i] + b[i]` */
+        template <nan_policy P = nan_policy::propagate, typename T>
+        inline void add(const T* a, const T* b, T* out, std::size_t n, const bounds<T>& limits) noexcept {
+            if constexpr (std::is_floating_point_v<T>) {
+                add<P>(a, b, out, n, limits.lo, limits.hi);
+            } else if constexpr (detail::has_plain_wide_lanes_v<T>) {
+                detail::transform_bounded<detail::wide_lane_t<T>>([](const auto& x, const auto& y) noexcept { return x + y; }, out, n, limits, a, b);
+            } else {
+                for (std::size_t i = 0; i < n; ++i) out[i] = limits.clamp(static_cast<T>(dynamic_type<T>{ a[i], bounds<T>{} } + b[i]));
+            }
+        }
+
+        /** `out[i] = a[i] + offset` */
+        template <nan_policy P = nan_policy::propagate, typename T>
+        inline void add(const T* a, const T offset, T* out, std::size_t n, const bounds<T>& limits) noexcept {
+            if constexpr (std::is_floating_point_v<T>) {
+                add<P>(a, offset, out, n, limits.lo, limits.hi);
+            } else if constexpr (detail::has_plain_wide_lanes_v<T>) {
+                using W = detail::wide_lane_t<T>;
+                const W w = offset;
+                detail::transform_bounded<W>([w](const auto& x) noexcept { return x + w; }, out, n, limits, a);
+            } else {
+                for (std::size_t i = 0; i < n; ++i) out[i] = limits.clamp(static_cast<T>(dynamic_type<T>{ a[i], bounds<T>{} } + offset));
+            }
+        }
+
+        /** `out[i] = a[i] - b[i]` */
+        template <nan_policy P = nan_policy::propagate, typename T>
+        inline void subtract(const T* a, const T* b, T* out, std::size_t n, const bounds<T>& limits) noexcept {
+            if constexpr (std::is_floating_point_v<T>) {
+                subtract<P>(a, b, out, n, limits.lo, limits.hi);
+            } else if constexpr (detail::has_plain_wide_lanes_v<T>) {
+                // Differences of unsigned values need signed lanes
+                detail::transform_bounded<detail::signed_wide_lane_t<T>>([](const auto& x, const auto& y) noexcept { return x - y; }, out, n, limits, a, b);
+            } else {
+                for (std::size_t i = 0; i < n; ++i) out[i] = limits.clamp(static_cast<T>(dynamic_type<T>{ a[i], bounds<T>{} } - b[i]));
+            }
+        }
+
+        /** `out[i] = a[i] * b[i]` */
+        template <nan_policy P = nan_policy::propagate, typename T>
+        inline void multiply(const T* a, const T* b, T* out, std::size_t n, const bounds<T>& limits) noexcept {
+            if constexpr (std::is_floating_point_v<T>) {
+                multiply<P>(a, b, out, n, limits.lo, limits.hi);
+            } else if constexpr (detail::has_plain_wide_lanes_v<T>) {
+                detail::transform_bounded<detail::wide_lane_t<T>>([](const auto& x, const auto& y) noexcept { return x * y; }, out, n, limits, a, b);
+            } else {
+                for (std::size_t i = 0; i < n; ++i) out[i] = limits.clamp(static_cast<T>(dynamic_type<T>{ a[i], bounds<T>{} } * b[i]));
+            }
+        }
+
+        /** `out[i] = a[i] * gain` */
+        template <nan_policy P = nan_policy::propagate, typename T>
+        inline void multiply(const T* a, const T gain, T* out, std::size_t n, const bounds<T>& limits) noexcept {
+            if constexpr (std::is_floating_point_v<T>) {
+                multiply<P>(a, gain, out, n, limits.lo, limits.hi);
+            } else if constexpr (detail::has_plain_wide_lanes_v<T>) {
+                using W = detail::wide_lane_t<T>;
+                const W w = gain;
+                detail::transform_bounded<W>([w](const auto& x) noexcept { return x * w; }, out, n, limits, a);
+            } else {
+                for (std::size_t i = 0; i < n; ++i) out[i] = limits.clamp(static_cast<T>(dynamic_type<T>{ a[i], bounds<T>{} } * gain));
+            }
+        }
+    } // namespace batch
+} // namespace saturating
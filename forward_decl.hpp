@@ -15,4 +15,14 @@ namespace saturating {
               std::enable_if_t<!std::is_const_v<T>,    std::conditional_t<std::is_integral_v<T>, std::decay_t<T>, int>> MIN,
               std::enable_if_t<!std::is_volatile_v<T>, std::conditional_t<std::is_integral_v<T>, std::decay_t<T>, int>> MAX>
     class type;
+
+    /** Trait detecting any `saturating::type` instantiation. */
+    template <typename T>
+    struct is_type : std::false_type {};
+
+    template <typename T, auto MIN, auto MAX>
+    struct is_type<type<T, MIN, MAX>> : std::true_type {};
+
+    template <typename T>
+    constexpr bool is_type_v = is_type<std::remove_cv_t<std::remove_reference_t<T>>>::value;
 }
@@ -10,6 +10,141 @@
 #include "./utilities.hpp"
 
 namespace saturating {
+    namespace detail {
+        /** Clamp an intermediate result to `MIN ... MAX` of `T`, rounding floating point values for integral `T`. */
+        template <typename T, auto MIN, auto MAX, typename V>
+        constexpr std::decay_t<T> __attribute__((const))
+        clamp_result(const V val) noexcept {
+            if constexpr (std::is_floating_point_v<V> && std::is_integral_v<std::decay_t<T>>) {
+                return clamp_result<T, MIN, MAX>(round<T>(val));
+            } else {
+                return static_cast<std::decay_t<T>>(clamp(static_cast<V>(MIN), val, static_cast<V>(MAX)));
+            }
+        }
+
+        /** Does every value of the integral `U` fit `T`? */
+        template <typename T, typename U>
+        constexpr bool fits_v = std::is_integral_v<T> && std::is_integral_v<U>
+                                && (std::is_signed_v<T> == std::is_signed_v<U> ? sizeof(U) <= sizeof(T) : std::is_signed_v<T> && sizeof(U) < sizeof(T));
+
+        /** Is the integral `a` below zero (without comparing unsigned values against zero)? */
+        template <typename U>
+        constexpr bool __attribute__((const))
+        is_negative(const U a) noexcept {
+            if constexpr (std::is_signed_v<U>) {
+                return a < 0;
+            } else {
+                return false;
+            }
+        }
+
+        /** Magnitude of the integral `a` in the unsigned `M`, exact for the lowest two's complement value. */
+        template <typename M, typename U>
+        constexpr M __attribute__((const))
+        magnitude(const U a) noexcept {
+            return is_negative(a) ? static_cast<M>(M{0} - static_cast<M>(a)) : static_cast<M>(a);
+        }
+
+#ifdef __SIZEOF_INT128__
+        /**
+         * The integral of sign `negative` and magnitude `m` clamped to `MIN ... MAX`. Takes the results of
+         * 128 bit operands, which `wide_signed_t` does not widen: magnitudes up to 2^128 - 1 are exact,
+         * larger ones are passed as 2^128 - 1, which is beyond every limit but those of `__uint128_t`.
+         */
+        template <typename T, auto MIN, auto MAX>
+        constexpr std::decay_t<T> __attribute__((const))
+        clamp_magnitude(const bool negative, const __uint128_t m) noexcept {
+            using R = std::decay_t<T>;
+            if constexpr (std::is_same_v<R, __uint128_t>) {
+                return negative && m != 0 ? MIN : clamp(MIN, m, MAX);
+            } else {
+                // Every other limit fits `__int128_t`, as do the magnitudes up to 2^127 of negative values
+                constexpr __uint128_t limit = __uint128_t{1} << 127;
+                if (m > limit || (m == limit && !negative)) return static_cast<R>(negative ? MIN : MAX);
+                return clamp_result<T, MIN, MAX>(negative ? static_cast<__int128_t>(__uint128_t{0} - m) : static_cast<__int128_t>(m));
+            }
+        }
+
+        /**
+         * `a OP b` (`+`, `-` or `*`) clamped to `MIN ... MAX` for 128 bit operands. The overflow builtins
+         * give the exact result when it fits `__int128_t` or `__uint128_t`, beyond both it saturates
+         * by the signs of the operands.
+         */
+        template <typename T, auto MIN, auto MAX, char OP, typename UA, typename UB>
+        constexpr std::decay_t<T> __attribute__((const))
+        overflow_result(const UA a, const UB b) noexcept {
+            static_assert(OP == '+' || OP == '-' || OP == '*');
+            const auto apply = [a, b](auto* out) constexpr noexcept {
+                if constexpr (OP == '+') {
+                    return __builtin_add_overflow(a, b, out);
+                } else if constexpr (OP == '-') {
+                    return __builtin_sub_overflow(a, b, out);
+                } else {
+                    return __builtin_mul_overflow(a, b, out);
+                }
+            };
+            __int128_t s = 0;
+            if (!apply(&s)) return clamp_magnitude<T, MIN, MAX>(s < 0, magnitude<__uint128_t>(s));
+            __uint128_t u = 0;
+            if (!apply(&u)) return clamp_magnitude<T, MIN, MAX>(false, u);
+            // Operands lie in -2^127 ... 2^128 - 1: sums fall below that only with a negative operand,
+            // differences only when `b` is not negative
+            const bool negative = OP == '+' ? is_negative(a) || is_negative(b)
+                                            : (OP == '-' ? !is_negative(b) : is_negative(a) != is_negative(b));
+            return static_cast<std::decay_t<T>>(negative ? MIN : MAX);
+        }
+#endif
+
+        /**
+         * Integral product clamped to `MIN ... MAX` in a signed type wide enough for operands of mixed signedness.
+         * Of the operands `wide_signed_t<W...>` widens, only two unsigned 64 bit ones can overflow it, and their
+         * product is positive; 128 bit operands use the overflow builtins.
+         */
+        template <typename T, auto MIN, auto MAX, typename... W, typename UA, typename UB>
+        constexpr std::decay_t<T> __attribute__((const))
+        multiply_wide(const UA a, const UB b) noexcept {
+            if constexpr (!widens_v<W..., UA, UB>) {
+                return overflow_result<T, MIN, MAX, '*'>(a, b);
+            } else {
+                using V = wide_signed_t<W..., UA, UB>;
+                V product = 0;
+                if (__builtin_mul_overflow(static_cast<V>(a), static_cast<V>(b), &product)) return static_cast<std::decay_t<T>>(MAX);
+                return static_cast<std::decay_t<T>>(clamp(static_cast<V>(MIN), product, static_cast<V>(MAX)));
+            }
+        }
+
+        /** Floor of the square root of `x`. */
+        template <typename M>
+        constexpr M __attribute__((const))
+        isqrt(M x) noexcept {
+            static_assert(std::is_unsigned_v<M>);
+            if (!__builtin_is_constant_evaluated() && sizeof(M) <= sizeof(uint64_t)) {
+                // The double result is at most one off for 64 bit operands
+                const uint64_t val = static_cast<uint64_t>(x);
+                uint64_t r = static_cast<uint64_t>(std::sqrt(static_cast<double>(val)));
+                uint64_t sq = 0;
+                if (__builtin_mul_overflow(r, r, &sq) || sq > val) {
+                    --r;
+                } else if (!__builtin_mul_overflow(r + 1, r + 1, &sq) && sq <= val) {
+                    ++r;
+                }
+                return static_cast<M>(r);
+            }
+            M r = 0;
+            M bit = static_cast<M>(1) << (sizeof(M) * 8 - 2);
+            while (bit > x) bit >>= 2;
+            while (bit != 0) {
+                if (x >= r + bit) {
+                    x -= r + bit;
+                    r = (r >> 1) + bit;
+                } else {
+                    r >>= 1;
+                }
+                bit >>= 2;
+            }
+            return r;
+        }
+    } // namespace detail
     /**
      * Add a and b and store result in a new saturating type.
      * @param  a Left hand side of operator
@@ -30,7 +165,7 @@ namespace saturating {
               typename UB>
     constexpr std::enable_if_t<std::is_arithmetic_v<UA> && std::is_arithmetic_v<UB>, std::decay_t<T>>
     __attribute__((const))
-    add(const UA& a, const UB& b) noexcept {
+    add(const UA a, const UB b) noexcept {
         if constexpr (std::is_floating_point_v<T>) {
             if constexpr (std::is_floating_point_v<UA> || std::is_floating_point_v<UB>) {
                 return static_cast<std::decay_t<T>>(clamp(MIN, a + b, MAX));
@@ -47,13 +182,15 @@ namespace saturating {
                     } else {
                         return {
                             __builtin_add_overflow(static_cast<TC>(a), static_cast<TC>(b), &temp)
-                                ? (static_cast<TC>(b) > static_cast<TC>(a) ? MIN : MAX)
+                                ? (static_cast<TC>(b) < 0 ? MIN : MAX)
                                 : temp
                         };
                     }
+                } else if constexpr (!widens_v<UA, UB>) {
+                    return detail::overflow_result<T, MIN, MAX, '+'>(a, b);
                 } else {
-                    using TO = next_up_t<TC>;
-                    return static_cast<std::decay_t<T>>(clamp(MIN, static_cast<TO>(a) + static_cast<TO>(b), MAX));
+                    using W = wide_signed_t<UA, UB>;
+                    return static_cast<std::decay_t<T>>(clamp(static_cast<W>(MIN), static_cast<W>(a) + static_cast<W>(b), static_cast<W>(MAX)));
                 }
             }
         } else {
@@ -61,17 +198,15 @@ namespace saturating {
                 if constexpr (std::is_floating_point_v<UB>) {
                     return static_cast<std::decay_t<T>>(clamp(MIN, round<T>(a + b), MAX));
                 } else {
-                    const auto temp = round<T>(a);
-                    using TO = next_up_t<fit_all_t<UB, decltype(temp)>>;
-                    return static_cast<std::decay_t<T>>(clamp(MIN, static_cast<TO>(temp) + static_cast<TO>(b), MAX));
+                    // Rounds the sum like subtract does, not the operand: `11 + -2.5` is 9, `11 + round(-2.5)` would be 8
+                    return static_cast<std::decay_t<T>>(clamp(MIN, round<T>(a + b), MAX));
                 }
             } else {
                 if constexpr (std::is_floating_point_v<UB>) {
-                    const auto temp = round<T>(b);
-                    using TO = next_up_t<fit_all_t<UA, decltype(temp)>>;
-                    return static_cast<std::decay_t<T>>(clamp(MIN, static_cast<TO>(a) + static_cast<TO>(temp), MAX));
+                    return static_cast<std::decay_t<T>>(clamp(MIN, round<T>(a + b), MAX));
                 } else {
-                    if constexpr (MIN == std::numeric_limits<T>::lowest() && MAX == std::numeric_limits<T>::max() && std::is_same_v<T, fit_all_t<T, UA, UB>>) {
+                    // Overflow builtins only when both operands fit `T`, so an overflow goes the way of their (shared) sign
+                    if constexpr (MIN == std::numeric_limits<T>::lowest() && MAX == std::numeric_limits<T>::max() && detail::fits_v<T, UA> && detail::fits_v<T, UB>) {
                         T temp = 0;
                         if constexpr (std::is_unsigned_v<T>) {
                             return {
@@ -82,13 +217,16 @@ namespace saturating {
                         } else {
                             return {
                                 __builtin_add_overflow(static_cast<T>(a), static_cast<T>(b), &temp)
-                                    ? (static_cast<T>(b) > static_cast<T>(a) ? MIN : MAX)
+                                    ? (static_cast<T>(b) < 0 ? MIN : MAX)
                                     : temp
                             };
                         }
+                    } else if constexpr (!widens_v<T, UA, UB>) {
+                        return detail::overflow_result<T, MIN, MAX, '+'>(a, b);
                     } else {
-                        using TO = next_up_t<fit_all_t<UA, UB>>;
-                        return static_cast<std::decay_t<T>>(clamp(MIN, static_cast<TO>(a) + static_cast<TO>(b), MAX));
+                        // Signed, so sums of operands of mixed signedness into an unsigned or narrower `T` keep their sign
+                        using W = wide_signed_t<T, UA, UB>;
+                        return static_cast<std::decay_t<T>>(clamp(static_cast<W>(MIN), static_cast<W>(a) + static_cast<W>(b), static_cast<W>(MAX)));
                     }
                 }
             }
@@ -158,13 +296,15 @@ namespace saturating {
               typename UB>
     constexpr std::enable_if_t<std::is_arithmetic_v<UA> && std::is_arithmetic_v<UB>, std::decay_t<T>>
     __attribute__((const))
-    subtract(const UA& a, const UB& b) noexcept {
-        using TO = next_up_t<fit_all_t<UA, UB>>;
+    subtract(const UA a, const UB b) noexcept {
         if constexpr (std::is_floating_point_v<T>) {
             if constexpr (std::is_floating_point_v<UA> || std::is_floating_point_v<UB>) {
                 return clamp(MIN, a - b, MAX);
+            } else if constexpr (!widens_v<UA, UB>) {
+                return detail::overflow_result<T, MIN, MAX, '-'>(a, b);
             } else {
-                return clamp(MIN, static_cast<TO>(a) - b, MAX);
+                using W = wide_signed_t<UA, UB>;
+                return static_cast<std::decay_t<T>>(clamp(static_cast<W>(MIN), static_cast<W>(a) - static_cast<W>(b), static_cast<W>(MAX)));
             }
         } else {
             if constexpr (std::is_floating_point_v<UA>) {
@@ -176,8 +316,12 @@ namespace saturating {
             } else {
                 if constexpr (std::is_floating_point_v<UB>) {
                     return static_cast<std::decay_t<T>>(clamp(MIN, round<T>(a - b), MAX));
+                } else if constexpr (!widens_v<T, UA, UB>) {
+                    return detail::overflow_result<T, MIN, MAX, '-'>(a, b);
                 } else {
-                    return static_cast<std::decay_t<T>>(clamp(MIN, static_cast<TO>(a) - static_cast<TO>(b), MAX));
+                    // Signed, so differences of unsigned operands can go below zero, and holding the limits
+                    using W = wide_signed_t<T, UA, UB>;
+                    return static_cast<std::decay_t<T>>(clamp(static_cast<W>(MIN), static_cast<W>(a) - static_cast<W>(b), static_cast<W>(MAX)));
                 }
             }
         }
@@ -196,13 +340,12 @@ namespace saturating {
               typename UB>
     constexpr std::enable_if_t<std::is_arithmetic_v<UA> && std::is_arithmetic_v<UB>, std::decay_t<T>>
     __attribute__((const))
-    multiply(const UA& a, const UB& b) noexcept {
-        using TO = next_up_t<fit_all_t<UA, UB>>;
+    multiply(const UA a, const UB b) noexcept {
         if constexpr (std::is_floating_point_v<T>) {
             if constexpr (std::is_floating_point_v<UA> || std::is_floating_point_v<UB>) {
                 return clamp(MIN, a * b, MAX);
             } else {
-                return clamp(MIN, static_cast<TO>(a) * b, MAX);
+                return detail::multiply_wide<T, MIN, MAX>(a, b);
             }
         } else {
             if constexpr (std::is_floating_point_v<UA>) {
@@ -215,7 +358,7 @@ namespace saturating {
                 if constexpr (std::is_floating_point_v<UB>) {
                     return clamp(MIN, round<T>(a * b), MAX);
                 } else {
-                    return clamp(MIN, static_cast<TO>(a) * static_cast<TO>(b), MAX);
+                    return detail::multiply_wide<T, MIN, MAX, T>(a, b);
                 }
             }
         }
@@ -234,20 +377,392 @@ namespace saturating {
               typename UB>
     constexpr std::enable_if_t<std::is_arithmetic_v<UA> && std::is_arithmetic_v<UB>, std::decay_t<T>>
     __attribute__((const))
-    divide(const UA& a, const UB& b) noexcept {
-        using TO = next_up_t<fit_all_t<UA, UB>>;
+    divide(const UA a, const UB b) noexcept {
         if constexpr (std::is_floating_point_v<UA> || std::is_floating_point_v<UB>) {
             if constexpr (std::is_floating_point_v<T>) {
                 return static_cast<std::decay_t<T>>(clamp(MIN, a / b, MAX));
             } else {
                 return static_cast<std::decay_t<T>>(clamp(MIN, round<T>(a / b), MAX));
             }
+        } else if constexpr (!widens_v<T, UA, UB>) {
+            // 128 bit operands: rounded half away from zero on the magnitudes, `r >= b - r` is `2 r >= b` without overflow
+            if (b == 0) {
+                return detail::clamp_magnitude<T, MIN, MAX>(detail::is_negative(a), a == 0 ? 0 : ~__uint128_t{0});
+            }
+            const auto ma = detail::magnitude<__uint128_t>(a);
+            const auto mb = detail::magnitude<__uint128_t>(b);
+            const __uint128_t r = ma % mb;
+            return detail::clamp_magnitude<T, MIN, MAX>(detail::is_negative(a) != detail::is_negative(b), ma / mb + (r >= mb - r ? 1 : 0));
+        } else {
+            // Rounded half away from zero, wide enough for `a + b / 2`. Division by zero saturates towards the sign of `a`.
+            using W = wide_signed_t<T, UA, UB>;
+            const W wa = static_cast<W>(a);
+            const W wb = static_cast<W>(b);
+            if (wb == 0) {
+                return static_cast<std::decay_t<T>>(wa > 0 ? MAX : (wa < 0 ? MIN : clamp(static_cast<W>(MIN), W{0}, static_cast<W>(MAX))));
+            }
+            return static_cast<std::decay_t<T>>(clamp(static_cast<W>(MIN), ((wa < 0) ^ (wb < 0)) ? ((wa - wb/2)/wb) : ((wa + wb/2)/wb), static_cast<W>(MAX)));
+        }
+    }
+
+    /**
+     * Remainder of `a / b` truncated towards zero, so it takes the sign of `a`. Computed on the magnitudes, exact for
+     * mixed signedness and for `lowest % -1` (zero, where the plain operator traps). A zero divisor leaves `a`.
+     * @param  a Dividend
+     * @param  b Divisor
+     * @return   `a % b`, clamped to `MIN ... MAX`
+     */
+    template <typename T,
+              std::conditional_t<std::is_floating_point_v<T>, int, std::decay_t<T>>
+                    MIN = std::is_floating_point_v<T>
+                            ? -1
+                            : (std::conditional_t<std::is_floating_point_v<T>, int, std::decay_t<T>>)std::numeric_limits<T>::lowest(),
+              std::conditional_t<std::is_floating_point_v<T>, int, std::decay_t<T>>
+                    MAX = std::is_floating_point_v<T>
+                            ? 1
+                            : (std::conditional_t<std::is_floating_point_v<T>, int, std::decay_t<T>>)std::numeric_limits<T>::max(),
+              typename UA,
+              typename UB>
+    constexpr std::enable_if_t<std::is_arithmetic_v<UA> && std::is_arithmetic_v<UB>, std::decay_t<T>>
+    __attribute__((const))
+    modulo(const UA a, const UB b) noexcept {
+        if constexpr (std::is_floating_point_v<UA> || std::is_floating_point_v<UB>) {
+            // In the type the operands promote to, like the other operations (`std::fmod` would take an `int` as `double`)
+            using C = std::common_type_t<UA, UB>;
+            return detail::clamp_result<T, MIN, MAX>(b == 0 ? static_cast<C>(a) : std::fmod(static_cast<C>(a), static_cast<C>(b)));
+        } else {
+            using M = std::make_unsigned_t<std::common_type_t<UA, UB>>;
+            const bool negative = detail::is_negative(a);
+            const M mb = detail::magnitude<M>(b);
+            const M m = mb == 0 ? detail::magnitude<M>(a) : static_cast<M>(detail::magnitude<M>(a) % mb);
+            if constexpr (std::is_floating_point_v<T>) {
+                return detail::clamp_result<T, MIN, MAX>(negative ? -static_cast<std::decay_t<T>>(m) : static_cast<std::decay_t<T>>(m));
+            } else if constexpr (!widens_v<T, UA, UB>) {
+                return detail::clamp_magnitude<T, MIN, MAX>(negative, m);
+            } else {
+                using W = wide_signed_t<T, UA, UB>;
+                return detail::clamp_result<T, MIN, MAX>(negative ? -static_cast<W>(m) : static_cast<W>(m));
+            }
+        }
+    }
+
+    /**
+     * Negate `a`. Saturates where plain negation overflows, like negating the lowest two's complement value.
+     * @param  a Operand
+     * @return   `-a`, clamped to `MIN ... MAX`
+     */
+    template <typename T,
+              std::conditional_t<std::is_floating_point_v<T>, int, std::decay_t<T>>
+                    MIN = std::is_floating_point_v<T>
+                            ? -1
+                            : (std::conditional_t<std::is_floating_point_v<T>, int, std::decay_t<T>>)std::numeric_limits<T>::lowest(),
+              std::conditional_t<std::is_floating_point_v<T>, int, std::decay_t<T>>
+                    MAX = std::is_floating_point_v<T>
+                            ? 1
+                            : (std::conditional_t<std::is_floating_point_v<T>, int, std::decay_t<T>>)std::numeric_limits<T>::max(),
+              typename U>
+    constexpr std::enable_if_t<std::is_arithmetic_v<U>, std::decay_t<T>>
+    __attribute__((const))
+    negate(const U a) noexcept {
+        if constexpr (std::is_floating_point_v<U>) {
+            return detail::clamp_result<T, MIN, MAX>(-a);
+        } else if constexpr (std::is_floating_point_v<T>) {
+            return detail::clamp_result<T, MIN, MAX>(-static_cast<std::decay_t<T>>(a));
+        } else if constexpr (!widens_v<T, U>) {
+            return detail::clamp_magnitude<T, MIN, MAX>(!detail::is_negative(a), detail::magnitude<__uint128_t>(a));
+        } else {
+            return detail::clamp_result<T, MIN, MAX>(-static_cast<wide_signed_t<T, U>>(a));
+        }
+    }
+
+    /**
+     * Absolute value of `a`.
+     * @param  a Operand
+     * @return   `|a|`, clamped to `MIN ... MAX`
+     */
+    template <typename T,
+              std::conditional_t<std::is_floating_point_v<T>, int, std::decay_t<T>>
+                    MIN = std::is_floating_point_v<T>
+                            ? -1
+                            : (std::conditional_t<std::is_floating_point_v<T>, int, std::decay_t<T>>)std::numeric_limits<T>::lowest(),
+              std::conditional_t<std::is_floating_point_v<T>, int, std::decay_t<T>>
+                    MAX = std::is_floating_point_v<T>
+                            ? 1
+                            : (std::conditional_t<std::is_floating_point_v<T>, int, std::decay_t<T>>)std::numeric_limits<T>::max(),
+              typename U>
+    constexpr std::enable_if_t<std::is_arithmetic_v<U>, std::decay_t<T>>
+    __attribute__((const))
+    abs(const U a) noexcept {
+        if constexpr (std::is_floating_point_v<U>) {
+            return detail::clamp_result<T, MIN, MAX>(a < 0 ? -a : a);
+        } else if constexpr (!std::is_floating_point_v<T> && !widens_v<T, U>) {
+            return detail::clamp_magnitude<T, MIN, MAX>(false, detail::magnitude<__uint128_t>(a));
+        } else {
+            using W = std::conditional_t<std::is_floating_point_v<T>, std::decay_t<T>, wide_signed_t<T, U>>;
+            const W temp = static_cast<W>(a);
+            return detail::clamp_result<T, MIN, MAX>(temp < 0 ? -temp : temp);
+        }
+    }
+
+    /**
+     * Absolute difference of `a` and `b`, without the intermediate overflow of `abs(a - b)`.
+     * @param  a Left hand side of operator
+     * @param  b Right hand side of operator
+     * @return   `|a - b|`, clamped to `MIN ... MAX`
+     */
+    template <typename T,
+              std::conditional_t<std::is_floating_point_v<T>, int, std::decay_t<T>>
+                    MIN = std::is_floating_point_v<T>
+                            ? -1
+                            : (std::conditional_t<std::is_floating_point_v<T>, int, std::decay_t<T>>)std::numeric_limits<T>::lowest(),
+              std::conditional_t<std::is_floating_point_v<T>, int, std::decay_t<T>>
+                    MAX = std::is_floating_point_v<T>
+                            ? 1
+                            : (std::conditional_t<std::is_floating_point_v<T>, int, std::decay_t<T>>)std::numeric_limits<T>::max(),
+              typename UA,
+              typename UB>
+    constexpr std::enable_if_t<std::is_arithmetic_v<UA> && std::is_arithmetic_v<UB>, std::decay_t<T>>
+    __attribute__((const))
+    abs_diff(const UA a, const UB b) noexcept {
+        if constexpr (std::is_floating_point_v<UA> || std::is_floating_point_v<UB>) {
+            const auto temp = a - b;
+            return detail::clamp_result<T, MIN, MAX>(temp < 0 ? -temp : temp);
+        } else if constexpr (!std::is_floating_point_v<T> && !widens_v<T, UA, UB>) {
+            // One of `a - b` and `b - a` is not negative, it fits `__uint128_t` unless it is beyond every limit
+            __uint128_t temp = 0;
+            if (!__builtin_sub_overflow(a, b, &temp) || !__builtin_sub_overflow(b, a, &temp)) return detail::clamp_magnitude<T, MIN, MAX>(false, temp);
+            return static_cast<std::decay_t<T>>(MAX);
+        } else {
+            using W = std::conditional_t<std::is_floating_point_v<T>, std::decay_t<T>, wide_signed_t<T, UA, UB>>;
+            const W temp = static_cast<W>(a) - static_cast<W>(b);
+            return detail::clamp_result<T, MIN, MAX>(temp < 0 ? -temp : temp);
+        }
+    }
+
+    /**
+     * Shift `a` left by `shift` bits (multiply by 2^shift), saturating instead of losing bits.
+     * @param  a     Integral operand
+     * @param  shift Number of bits
+     * @return       `a * 2^shift`, clamped to `MIN ... MAX`
+     */
+    template <typename T,
+              std::conditional_t<std::is_floating_point_v<T>, int, std::decay_t<T>>
+                    MIN = std::is_floating_point_v<T>
+                            ? -1
+                            : (std::conditional_t<std::is_floating_point_v<T>, int, std::decay_t<T>>)std::numeric_limits<T>::lowest(),
+              std::conditional_t<std::is_floating_point_v<T>, int, std::decay_t<T>>
+                    MAX = std::is_floating_point_v<T>
+                            ? 1
+                            : (std::conditional_t<std::is_floating_point_v<T>, int, std::decay_t<T>>)std::numeric_limits<T>::max(),
+              typename U>
+    constexpr std::enable_if_t<std::is_integral_v<U> && std::is_integral_v<std::decay_t<T>>, std::decay_t<T>>
+    __attribute__((const))
+    shift_left(const U a, unsigned shift) noexcept {
+        if constexpr (!widens_v<T, U>) {
+            if (shift >= 128) return detail::clamp_magnitude<T, MIN, MAX>(detail::is_negative(a), a == 0 ? 0 : ~__uint128_t{0});
+            return detail::overflow_result<T, MIN, MAX, '*'>(a, __uint128_t{1} << shift);
+        } else {
+            using W = wide_signed_t<T, U>;
+            // Any non zero value saturates beyond this, and it keeps the limits below exact in `W`
+            shift = min(shift, static_cast<unsigned>(sizeof(std::decay_t<T>) * 8 + 1));
+            // The operand range that does not saturate: ceil(MIN / 2^shift) ... floor(MAX / 2^shift)
+            const W hi = static_cast<W>(MAX) >> shift;
+            const W lo = -(-static_cast<W>(MIN) >> shift);
+            const W temp = static_cast<W>(a);
+            return static_cast<std::decay_t<T>>(temp > hi
+                                                    ? MAX
+                                                    : (temp < lo ? MIN : temp * (static_cast<W>(1) << shift)));
+        }
+    }
+
+    /**
+     * Square `a`.
+     * @param  a Operand
+     * @return   `a * a`, clamped to `MIN ... MAX`
+     */
+    template <typename T,
+              std::conditional_t<std::is_floating_point_v<T>, int, std::decay_t<T>>
+                    MIN = std::is_floating_point_v<T>
+                            ? -1
+                            : (std::conditional_t<std::is_floating_point_v<T>, int, std::decay_t<T>>)std::numeric_limits<T>::lowest(),
+              std::conditional_t<std::is_floating_point_v<T>, int, std::decay_t<T>>
+                    MAX = std::is_floating_point_v<T>
+                            ? 1
+                            : (std::conditional_t<std::is_floating_point_v<T>, int, std::decay_t<T>>)std::numeric_limits<T>::max(),
+              typename U>
+    constexpr std::enable_if_t<std::is_arithmetic_v<U>, std::decay_t<T>>
+    __attribute__((const))
+    square(const U a) noexcept {
+        return multiply<T, MIN, MAX>(a, a);
+    }
+
+    /**
+     * Raise `a` to the integral power `exponent`. Integral results stop multiplying as soon as
+     * saturation is certain. Floating point operands use `std::pow` and are not `constexpr`.
+     * Integral results of negative exponents are `1 / a^-exponent` truncated towards zero: `1` and
+     * `-1` raised to them keep their magnitude, any other base (zero included) gives zero.
+     * @param  a        Base
+     * @param  exponent Exponent, of any integral type
+     * @return          `a^exponent`, clamped to `MIN ... MAX`
+     */
+    template <typename T,
+              std::conditional_t<std::is_floating_point_v<T>, int, std::decay_t<T>>
+                    MIN = std::is_floating_point_v<T>
+                            ? -1
+                            : (std::conditional_t<std::is_floating_point_v<T>, int, std::decay_t<T>>)std::numeric_limits<T>::lowest(),
+              std::conditional_t<std::is_floating_point_v<T>, int, std::decay_t<T>>
+                    MAX = std::is_floating_point_v<T>
+                            ? 1
+                            : (std::conditional_t<std::is_floating_point_v<T>, int, std::decay_t<T>>)std::numeric_limits<T>::max(),
+              typename U,
+              typename E>
+    constexpr std::enable_if_t<std::is_arithmetic_v<U> && std::is_integral_v<E> && !std::is_same_v<E, bool>, std::decay_t<T>>
+    __attribute__((const))
+    pow(const U a, const E exponent) noexcept {
+        if constexpr (std::is_floating_point_v<U> || std::is_floating_point_v<T>) {
+            return detail::clamp_result<T, MIN, MAX>(std::pow(a, exponent));
+        } else {
+            using W = wide_signed_t<T, U>;
+            using M = wide_unsigned_t<T, U>;
+            const bool negative = detail::is_negative(a) && (exponent & 1);
+            const auto result_of = [negative](const M magnitude) constexpr noexcept {
+                if constexpr (widens_v<T, U>) {
+                    return detail::clamp_result<T, MIN, MAX>(negative ? -static_cast<W>(magnitude) : static_cast<W>(magnitude));
+                } else {
+                    return detail::clamp_magnitude<T, MIN, MAX>(negative, magnitude);
+                }
+            };
+            M base = detail::magnitude<M>(a);
+            if (detail::is_negative(exponent)) return result_of(base == 1 ? 1 : 0);
+
+            // Largest magnitude that can be represented, anything above saturates
+            constexpr M limit = max(detail::magnitude<M>(MIN), detail::magnitude<M>(MAX));
+            const auto saturated = static_cast<std::decay_t<T>>(negative ? MIN : MAX);
+            auto e = static_cast<std::make_unsigned_t<E>>(exponent);
+            M result = 1;
+            while (true) {
+                if (e & 1) {
+                    if (__builtin_mul_overflow(result, base, &result) || result > limit) return saturated;
+                }
+                e >>= 1;
+                if (e == 0) break;
+                // `result` is at least one and will be multiplied by at least `base` again
+                if (__builtin_mul_overflow(base, base, &base) || base > limit) return saturated;
+            }
+            return result_of(result);
+        }
+    }
+
+    /**
+     * Square root of `a`, rounded down for integral types. Negative values give zero.
+     * @param  a Operand
+     * @return   `sqrt(a)`, clamped to `MIN ... MAX`
+     */
+    template <typename T,
+              std::conditional_t<std::is_floating_point_v<T>, int, std::decay_t<T>>
+                    MIN = std::is_floating_point_v<T>
+                            ? -1
+                            : (std::conditional_t<std::is_floating_point_v<T>, int, std::decay_t<T>>)std::numeric_limits<T>::lowest(),
+              std::conditional_t<std::is_floating_point_v<T>, int, std::decay_t<T>>
+                    MAX = std::is_floating_point_v<T>
+                            ? 1
+                            : (std::conditional_t<std::is_floating_point_v<T>, int, std::decay_t<T>>)std::numeric_limits<T>::max(),
+              typename U>
+    constexpr std::enable_if_t<std::is_arithmetic_v<U>, std::decay_t<T>>
+    __attribute__((const))
+    sqrt(const U a) noexcept {
+        if constexpr (std::is_floating_point_v<U> || std::is_floating_point_v<T>) {
+            return detail::clamp_result<T, MIN, MAX>(a > 0 ? std::sqrt(a) : decltype(std::sqrt(a)){0});
+        } else if constexpr (!widens_v<T, U>) {
+            return detail::clamp_magnitude<T, MIN, MAX>(false, a > 0 ? detail::isqrt(static_cast<__uint128_t>(a)) : 0);
+        } else {
+            using W = wide_signed_t<T, U>;
+            return detail::clamp_result<T, MIN, MAX>(a > 0 ? static_cast<W>(detail::isqrt(static_cast<std::make_unsigned_t<std::decay_t<U>>>(a)))
+                                                           : W{0});
+        }
+    }
+
+    /**
+     * Shift `a` right by `shift` bits, rounding to nearest (halfway cases up), and saturate the result
+     * into `T`. With a narrower `T` this is the fixed point requantization step (`sqrshrn` / `uqrshrn`).
+     * @param  a     Integral operand
+     * @param  shift Number of bits
+     * @return       `round(a / 2^shift)`, clamped to `MIN ... MAX`
+     */
+    template <typename T,
+              std::conditional_t<std::is_floating_point_v<T>, int, std::decay_t<T>>
+                    MIN = std::is_floating_point_v<T>
+                            ? -1
+                            : (std::conditional_t<std::is_floating_point_v<T>, int, std::decay_t<T>>)std::numeric_limits<T>::lowest(),
+              std::conditional_t<std::is_floating_point_v<T>, int, std::decay_t<T>>
+                    MAX = std::is_floating_point_v<T>
+                            ? 1
+                            : (std::conditional_t<std::is_floating_point_v<T>, int, std::decay_t<T>>)std::numeric_limits<T>::max(),
+              typename U>
+    constexpr std::enable_if_t<std::is_integral_v<U> && std::is_integral_v<std::decay_t<T>>, std::decay_t<T>>
+    __attribute__((const))
+    rounding_shift_right(const U a, unsigned shift) noexcept {
+        using V = std::decay_t<U>;
+        using W = wide_signed_t<T, V>;
+        if (shift == 0) {
+            return detail::clamp_result<T, MIN, MAX>(static_cast<W>(a));
+        } else if (shift > sizeof(V) * 8) {
+            return detail::clamp_result<T, MIN, MAX>(W{0});
+        }
+        // Adding the rounding bit after the shift, so it cannot overflow
+        const V temp = static_cast<V>(static_cast<V>(a) >> (shift - 1));
+        return detail::clamp_result<T, MIN, MAX>(static_cast<W>(static_cast<V>(temp >> 1)) + static_cast<W>(temp & 1));
+    }
+
+    /**
+     * Add one to `a`, stopping at `MAX`.
+     */
+    template <typename T,
+              std::conditional_t<std::is_floating_point_v<T>, int, std::decay_t<T>>
+                    MIN = std::is_floating_point_v<T>
+                            ? -1
+                            : (std::conditional_t<std::is_floating_point_v<T>, int, std::decay_t<T>>)std::numeric_limits<T>::lowest(),
+              std::conditional_t<std::is_floating_point_v<T>, int, std::decay_t<T>>
+                    MAX = std::is_floating_point_v<T>
+                            ? 1
+                            : (std::conditional_t<std::is_floating_point_v<T>, int, std::decay_t<T>>)std::numeric_limits<T>::max(),
+              typename U>
+    constexpr std::enable_if_t<std::is_arithmetic_v<U>, std::decay_t<T>>
+    __attribute__((const))
+    increment(const U a) noexcept {
+        if constexpr (std::is_floating_point_v<U> || std::is_floating_point_v<T>) {
+            return detail::clamp_result<T, MIN, MAX>(a + 1);
+        } else if constexpr (!widens_v<T, U>) {
+            return detail::overflow_result<T, MIN, MAX, '+'>(a, 1);
         } else {
-            return static_cast<std::decay_t<T>>(clamp(MIN, ((a < 0) ^ (b < 0)) ? ((a - b/2)/b) : ((a + b/2)/b), MAX));
+            return detail::clamp_result<T, MIN, MAX>(static_cast<wide_signed_t<T, U>>(a) + 1);
         }
     }
 
-    //TODO: increments, pow, square, sqrt, etc...
+    /**
+     * Subtract one from `a`, stopping at `MIN`.
+     */
+    template <typename T,
+              std::conditional_t<std::is_floating_point_v<T>, int, std::decay_t<T>>
+                    MIN = std::is_floating_point_v<T>
+                            ? -1
+                            : (std::conditional_t<std::is_floating_point_v<T>, int, std::decay_t<T>>)std::numeric_limits<T>::lowest(),
+              std::conditional_t<std::is_floating_point_v<T>, int, std::decay_t<T>>
+                    MAX = std::is_floating_point_v<T>
+                            ? 1
+                            : (std::conditional_t<std::is_floating_point_v<T>, int, std::decay_t<T>>)std::numeric_limits<T>::max(),
+              typename U>
+    constexpr std::enable_if_t<std::is_arithmetic_v<U>, std::decay_t<T>>
+    __attribute__((const))
+    decrement(const U a) noexcept {
+        if constexpr (std::is_floating_point_v<U> || std::is_floating_point_v<T>) {
+            return detail::clamp_result<T, MIN, MAX>(a - 1);
+        } else if constexpr (!widens_v<T, U>) {
+            return detail::overflow_result<T, MIN, MAX, '-'>(a, 1);
+        } else {
+            return detail::clamp_result<T, MIN, MAX>(static_cast<wide_signed_t<T, U>>(a) - 1);
+        }
+    }
 
     template <typename UA, typename UB, typename T>
     constexpr void add(const UA& a, const UB& b, T& out) noexcept { out = add<T>(a, b); }
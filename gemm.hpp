@@ -0,0 +1,375 @@
+/**@file
+ * @brief Saturating matrix multiplication for 8 and 16 bit saturating types.
+ *
+ * `C = round(A * B / 2^shift)`, saturated into the type of `C`. Products are summed exactly in a
+ * wide accumulator and each output is requantized (and saturated) only once, unlike a loop of
+ * `type::multiply` and `+=` which clamps every partial sum.
+ *
+ * Structure follows the usual packed GEMM layout: `B` and `A` blocks are copied into panels sized
+ * for the caches, a register tiled micro-kernel walks the panels, and rows of `C` are divided over
+ * threads. On x86 the micro-kernels use `pmaddwd` (or `vpdpwssd` with AVX-VNNI / AVX512-VNNI) on
+ * pairs of 16 bit (or widened 8 bit) values, summing in 32 bits and, for 16 bit inputs and deep 8
+ * bit products, widening to 64 bits before the sums can overflow; other targets use a portable
+ * vector extension kernel.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include "./types.hpp"
+#include "./simd.hpp"
+#include "./batch.hpp"
+#include "./parallel.hpp"
+
+namespace saturating {
+    namespace detail::gemm {
+        constexpr std::size_t MR = 4;    //< Rows of a register tile
+        constexpr std::size_t KC = 256;  //< Depth of a packed block (L1 / L2)
+        constexpr std::size_t MC = 64;   //< Rows of a packed `A` block (L2)
+        constexpr std::size_t NC = 256;  //< Columns of a packed `B` block (L2 / L3)
+
+        /**
+         * Portable micro-kernel: adds the product of an `MR x kc` panel of `A` and a `kc x NR` panel
+         * of `B` (both packed with one `k` per step) to the `MR x NR` tile at `acc`.
+         */
+        template <typename P, typename R>
+        struct generic_kernel {
+            static constexpr std::size_t lanes = simd::lanes<R>;
+            static constexpr std::size_t vectors = 2;
+            static constexpr std::size_t NR = lanes * vectors;
+            static constexpr std::size_t KU = 1;  //< `k` values interleaved per packed step
+            using P_type = P;
+            using R_type = R;
+
+            static void run(std::size_t steps, const P* a, const P* b, R* acc, std::size_t stride) noexcept {
+                using V = simd::vector_t<R, lanes>;
+                V c[MR][vectors];
+                for (std::size_t i = 0; i < MR; ++i) {
+                    for (std::size_t v = 0; v < vectors; ++v) c[i][v] = simd::load<lanes>(acc + i * stride + v * lanes);
+                }
+                for (std::size_t k = 0; k < steps; ++k, a += MR, b += NR) {
+                    V bv[vectors];
+                    for (std::size_t v = 0; v < vectors; ++v) bv[v] = simd::convert<R>(simd::load<lanes>(b + v * lanes));
+                    for (std::size_t i = 0; i < MR; ++i) {
+                        const R ai = a[i];
+                        for (std::size_t v = 0; v < vectors; ++v) c[i][v] += ai * bv[v];
+                    }
+                }
+                for (std::size_t i = 0; i < MR; ++i) {
+                    for (std::size_t v = 0; v < vectors; ++v) simd::store<lanes>(acc + i * stride + v * lanes, c[i][v]);
+                }
+            }
+        };
+
+#if defined(__SSE2__)
+        /** Registers and multiply-add of the x86 kernels, on pairs of 16 bit values per 32 bit lane. */
+        struct madd_ops {
+#if defined(__AVX2__)
+            using reg = __m256i;
+            static reg load(const void* p) noexcept { return _mm256_loadu_si256(static_cast<const reg*>(p)); }
+            static void store(void* p, reg v) noexcept { _mm256_storeu_si256(static_cast<reg*>(p), v); }
+            static reg broadcast(int32_t v) noexcept { return _mm256_set1_epi32(v); }
+            static reg madd(reg acc, reg a, reg b) noexcept {
+#if defined(__AVXVNNI__)
+                return _mm256_dpwssd_avx_epi32(acc, a, b);
+#elif defined(__AVX512VNNI__) && defined(__AVX512VL__)
+                return _mm256_dpwssd_epi32(acc, a, b);
+#else
+                return _mm256_add_epi32(acc, _mm256_madd_epi16(a, b));
+#endif
+            }
+#else
+            using reg = __m128i;
+            static reg load(const void* p) noexcept { return _mm_loadu_si128(static_cast<const reg*>(p)); }
+            static void store(void* p, reg v) noexcept { _mm_storeu_si128(static_cast<reg*>(p), v); }
+            static reg broadcast(int32_t v) noexcept { return _mm_set1_epi32(v); }
+            static reg madd(reg acc, reg a, reg b) noexcept { return _mm_add_epi32(acc, _mm_madd_epi16(a, b)); }
+#endif
+            static constexpr std::size_t lanes = sizeof(reg) / sizeof(int32_t);
+            static constexpr std::size_t vectors = 2;
+            static constexpr std::size_t NR = lanes * vectors;
+            static constexpr std::size_t KU = 2;
+            using P_type = int16_t;
+
+            /** `c += a * b` over `steps` packed steps, `c` an `MR x NR` tile of 32 bit registers. */
+            static void multiply_add(reg (&c)[MR][vectors], std::size_t steps, const int16_t* a, const int16_t* b) noexcept {
+                for (std::size_t k = 0; k < steps; ++k, a += MR * KU, b += NR * KU) {
+                    reg bv[vectors];
+                    for (std::size_t v = 0; v < vectors; ++v) bv[v] = load(b + v * lanes * KU);
+                    for (std::size_t i = 0; i < MR; ++i) {
+                        int32_t pair = 0;
+                        std::memcpy(&pair, a + i * KU, sizeof(pair));
+                        const reg ai = broadcast(pair);
+                        for (std::size_t v = 0; v < vectors; ++v) c[i][v] = madd(c[i][v], ai, bv[v]);
+                    }
+                }
+            }
+        };
+
+        /**
+         * x86 micro-kernel for 16 bit packed values: `k` is interleaved in pairs so one multiply-add
+         * instruction produces the sum of two products per 32 bit lane.
+         */
+        struct madd_kernel : madd_ops {
+            using R_type = int32_t;
+
+            static void run(std::size_t steps, const int16_t* a, const int16_t* b, int32_t* acc, std::size_t stride) noexcept {
+                reg c[MR][vectors];
+                for (std::size_t i = 0; i < MR; ++i) {
+                    for (std::size_t v = 0; v < vectors; ++v) c[i][v] = load(acc + i * stride + v * lanes);
+                }
+                multiply_add(c, steps, a, b);
+                for (std::size_t i = 0; i < MR; ++i) {
+                    for (std::size_t v = 0; v < vectors; ++v) store(acc + i * stride + v * lanes, c[i][v]);
+                }
+            }
+        };
+
+        /**
+         * `madd_kernel` with 64 bit sums: the 32 bit sums of `FLUSH` steps are added to the 64 bit tile
+         * before they can overflow. The one pair of products that overflows `pmaddwd` itself,
+         * `-32768 * -32768` twice, wraps to `INT32_MIN`, which no true sum reaches: lanes are widened
+         * as `(x - 1) + 1`, reading it as `2^31`.
+         */
+        template <std::size_t FLUSH>
+        struct madd_wide_kernel : madd_ops {
+            using R_type = int64_t;
+
+            static void run(std::size_t steps, const int16_t* a, const int16_t* b, int64_t* acc, std::size_t stride) noexcept {
+                int64_t flushes = 0;
+                for (std::size_t done = 0; done < steps; ++flushes) {
+                    const std::size_t count = min(FLUSH, steps - done);
+                    reg c[MR][vectors] = {};
+                    multiply_add(c, count, a + done * MR * KU, b + done * NR * KU);
+                    for (std::size_t i = 0; i < MR; ++i) {
+                        for (std::size_t v = 0; v < vectors; ++v) widen_add(acc + i * stride + v * lanes, c[i][v]);
+                    }
+                    done += count;
+                }
+                for (std::size_t i = 0; i < MR; ++i) {
+                    for (std::size_t j = 0; j < NR; ++j) acc[i * stride + j] += flushes;
+                }
+            }
+
+        private:
+            /** `dst[0 ... lanes) += x - 1`, sign extended. */
+            static void widen_add(int64_t* dst, reg x) noexcept {
+#if defined(__AVX2__)
+                x = _mm256_sub_epi32(x, _mm256_set1_epi32(1));
+                const reg lo = _mm256_cvtepi32_epi64(_mm256_castsi256_si128(x));
+                const reg hi = _mm256_cvtepi32_epi64(_mm256_extracti128_si256(x, 1));
+                store(dst, _mm256_add_epi64(load(dst), lo));
+                store(dst + 4, _mm256_add_epi64(load(dst + 4), hi));
+#else
+                x = _mm_sub_epi32(x, _mm_set1_epi32(1));
+                const reg sign = _mm_srai_epi32(x, 31);
+                store(dst, _mm_add_epi64(load(dst), _mm_unpacklo_epi32(x, sign)));
+                store(dst + 2, _mm_add_epi64(load(dst + 2), _mm_unpackhi_epi32(x, sign)));
+#endif
+            }
+        };
+
+        /** Kernel for 32 bit sums of products of 8 bit values. */
+        using narrow_kernel_t = madd_kernel;
+
+        /**
+         * Kernel for 64 bit sums, `PAIR` the largest magnitude of a sum of two products. `pmaddwd`
+         * multiplies signed values, so unsigned 16 bit inputs beyond `INT16_MAX` use the portable kernel.
+         */
+        template <uint64_t PAIR, bool SIGNED_16>
+        using wide_kernel_t = std::conditional_t<SIGNED_16,
+                                                 madd_wide_kernel<PAIR == 0 ? std::numeric_limits<std::size_t>::max()
+                                                                            : max(std::size_t{ 1 }, static_cast<std::size_t>(std::numeric_limits<int32_t>::max() / PAIR))>,
+                                                 generic_kernel<int32_t, int64_t>>;
+#else
+        using narrow_kernel_t = generic_kernel<int16_t, int32_t>;
+
+        template <uint64_t PAIR, bool SIGNED_16>
+        using wide_kernel_t = generic_kernel<int32_t, int64_t>;
+#endif
+
+        constexpr std::size_t round_up(std::size_t n, std::size_t multiple) noexcept {
+            return (n + multiple - 1) / multiple * multiple;
+        }
+
+        /** Pack `rows x depth` of `src` into panels of `MR` rows, `KU` consecutive `k` per row and step, zero padded. */
+        template <std::size_t KU, typename P, typename S>
+        void pack_a(const S* src, std::size_t ld, std::size_t rows, std::size_t depth, P* dst) noexcept {
+            const std::size_t steps = round_up(depth, KU) / KU;
+            for (std::size_t r0 = 0; r0 < rows; r0 += MR) {
+                for (std::size_t s = 0; s < steps; ++s) {
+                    for (std::size_t i = 0; i < MR; ++i) {
+                        for (std::size_t u = 0; u < KU; ++u) {
+                            const std::size_t r = r0 + i;
+                            const std::size_t k = s * KU + u;
+                            *dst++ = (r < rows && k < depth) ? static_cast<P>(src[r * ld + k]) : P{0};
+                        }
+                    }
+                }
+            }
+        }
+
+        /** Pack `depth x cols` of `src` into panels of `NR` columns, `KU` consecutive `k` per column and step, zero padded. */
+        template <std::size_t NR, std::size_t KU, typename P, typename S>
+        void pack_b(const S* src, std::size_t ld, std::size_t depth, std::size_t cols, P* dst) noexcept {
+            const std::size_t steps = round_up(depth, KU) / KU;
+            for (std::size_t c0 = 0; c0 < cols; c0 += NR) {
+                for (std::size_t s = 0; s < steps; ++s) {
+                    for (std::size_t j = 0; j < NR; ++j) {
+                        for (std::size_t u = 0; u < KU; ++u) {
+                            const std::size_t c = c0 + j;
+                            const std::size_t k = s * KU + u;
+                            *dst++ = (c < cols && k < depth) ? static_cast<P>(src[k * ld + c]) : P{0};
+                        }
+                    }
+                }
+            }
+        }
+
+        /**
+         * Per thread packing and accumulation buffers, allocated before the threads start. `B` is packed
+         * for the whole depth of an `NC` column block, once per thread, so each `MC` row block finishes
+         * its sums over all of `k` and the accumulator stays `MC x NC` whatever the number of rows.
+         */
+        template <typename P, typename R, std::size_t NR>
+        struct workspace {
+            /** Elements of one packed `KC x NC` block of `B`. */
+            static constexpr std::size_t panel = round_up(NC, NR) * KC;
+
+            std::unique_ptr<P[]> a { new P[round_up(MC, MR) * KC] };
+            std::unique_ptr<P[]> b;
+            std::unique_ptr<R[]> acc { new R[round_up(MC, MR) * round_up(NC, NR)] };
+
+            void reserve(std::size_t depth) {
+                b.reset(new P[panel * max(std::size_t{ 1 }, round_up(depth, KC) / KC)]);
+            }
+        };
+
+        /** Compute rows `[row_begin, row_end)` of `C`. */
+        template <typename K, typename SC, typename SA, typename SB>
+        void run(std::size_t row_begin, std::size_t row_end, std::size_t n, std::size_t k,
+                 const SA* a, std::size_t lda, const SB* b, std::size_t ldb, SC* c, std::size_t ldc,
+                 unsigned shift, workspace<typename K::P_type, typename K::R_type, K::NR>& ws) noexcept {
+            using R = typename K::R_type;
+            constexpr std::size_t NR = K::NR;
+            constexpr std::size_t stride = round_up(NC, NR);
+
+            constexpr std::size_t panel = workspace<typename K::P_type, R, NR>::panel;
+
+            for (std::size_t jc = 0; jc < n; jc += NC) {
+                const std::size_t nc = min(NC, n - jc);
+                for (std::size_t pc = 0; pc < k; pc += KC) {
+                    pack_b<NR, K::KU>(b + pc * ldb + jc, ldb, min(KC, k - pc), nc, ws.b.get() + pc / KC * panel);
+                }
+
+                for (std::size_t ic = row_begin; ic < row_end; ic += MC) {
+                    const std::size_t mc = min(MC, row_end - ic);
+                    std::fill(ws.acc.get(), ws.acc.get() + round_up(mc, MR) * stride, R{0});
+
+                    for (std::size_t pc = 0; pc < k; pc += KC) {
+                        const std::size_t kc = min(KC, k - pc);
+                        const std::size_t steps = round_up(kc, K::KU) / K::KU;
+                        pack_a<K::KU>(a + ic * lda + pc, lda, mc, kc, ws.a.get());
+
+                        for (std::size_t jr = 0; jr < nc; jr += NR) {
+                            for (std::size_t ir = 0; ir < mc; ir += MR) {
+                                K::run(steps,
+                                       ws.a.get() + ir * steps * K::KU,
+                                       ws.b.get() + pc / KC * panel + jr * steps * K::KU,
+                                       ws.acc.get() + ir * stride + jr,
+                                       stride);
+                            }
+                        }
+                    }
+
+                    // The one saturating step per output
+                    for (std::size_t i = 0; i < mc; ++i) {
+                        batch::rounding_shift_right(reinterpret_cast<const type<R>*>(ws.acc.get() + i * stride),
+                                                    c + (ic + i) * ldc + jc,
+                                                    nc,
+                                                    shift);
+                    }
+                }
+            }
+        }
+
+        template <typename K, typename SC, typename SA, typename SB>
+        void dispatch(std::size_t m, std::size_t n, std::size_t k,
+                      const SA* a, std::size_t lda, const SB* b, std::size_t ldb, SC* c, std::size_t ldc,
+                      unsigned shift, unsigned threads) {
+            using P = typename K::P_type;
+            using R = typename K::R_type;
+            // Rows per thread: enough to keep the packing of `B` (repeated per thread) insignificant
+            const std::size_t chunks = parallel::chunk_count(m, threads, 4 * MR);
+            std::unique_ptr<workspace<P, R, K::NR>[]> ws { new workspace<P, R, K::NR>[chunks] };
+            for (std::size_t chunk = 0; chunk < chunks; ++chunk) ws[chunk].reserve(k);
+            parallel::for_each_chunk(m, chunks, [&](std::size_t chunk, std::size_t begin, std::size_t end) noexcept {
+                run<K>(begin, end, n, k, a, lda, b, ldb, c, ldc, shift, ws[chunk]);
+            });
+        }
+
+        /** Do all values of `S` fit a signed 16 bit lane? */
+        template <typename S>
+        constexpr bool fits_int16_v = static_cast<int64_t>(S::min_val) >= std::numeric_limits<int16_t>::lowest()
+                                      && static_cast<int64_t>(S::max_val) <= std::numeric_limits<int16_t>::max();
+
+        template <typename S>
+        constexpr uint64_t magnitude() noexcept {
+            return max(static_cast<int64_t>(S::max_val) < 0 ? static_cast<uint64_t>(-static_cast<int64_t>(S::max_val)) : static_cast<uint64_t>(S::max_val),
+                       static_cast<int64_t>(S::min_val) < 0 ? static_cast<uint64_t>(-static_cast<int64_t>(S::min_val)) : static_cast<uint64_t>(S::min_val));
+        }
+    } // namespace detail::gemm
+
+    /**
+     * Saturating matrix multiplication `C = round(A * B / 2^shift)` of row major matrices.
+     * The sums are exact; `shift` (rounding to nearest) and saturation into `SC` are applied once
+     * per output. 8 bit inputs accumulate in 32 bits when `k` allows it, otherwise in 64 bits.
+     * May throw `std::bad_alloc` for its packing buffers.
+     * @param  m       Rows of `A` and `C`
+     * @param  n       Columns of `B` and `C`
+     * @param  k       Columns of `A`, rows of `B`
+     * @param  a       `m x k` matrix of 8 or 16 bit saturating types
+     * @param  lda     Distance between rows of `A`, in elements
+     * @param  b       `k x n` matrix of 8 or 16 bit saturating types
+     * @param  ldb     Distance between rows of `B`, in elements
+     * @param  c       `m x n` result matrix of any integral saturating type
+     * @param  ldc     Distance between rows of `C`, in elements
+     * @param  shift   Requantization right shift
+     * @param  threads Maximum number of threads, 0 to use all cores
+     */
+    template <typename SC, typename SA, typename SB>
+    std::enable_if_t<is_type_v<SA> && is_type_v<SB> && is_type_v<SC>>
+    gemm(std::size_t m, std::size_t n, std::size_t k,
+         const SA* a, std::size_t lda, const SB* b, std::size_t ldb, SC* c, std::size_t ldc,
+         unsigned shift = 0, unsigned threads = 0)
+    {
+        using TA = typename SA::value_type;
+        using TB = typename SB::value_type;
+        static_assert(std::is_integral_v<TA> && std::is_integral_v<TB> && std::is_integral_v<typename SC::value_type>,
+                      "gemm requires integral saturating types");
+        static_assert(sizeof(TA) <= sizeof(int16_t) && sizeof(TB) <= sizeof(int16_t),
+                      "gemm inputs must be 8 or 16 bit saturating types");
+        if (m == 0 || n == 0) return;
+
+        constexpr uint64_t product = detail::gemm::magnitude<SA>() * detail::gemm::magnitude<SB>();
+        if constexpr (sizeof(TA) == 1 && sizeof(TB) == 1) {
+            if (product == 0 || k <= std::numeric_limits<int32_t>::max() / product) {
+                detail::gemm::dispatch<detail::gemm::narrow_kernel_t>(m, n, k, a, lda, b, ldb, c, ldc, shift, threads);
+                return;
+            }
+        }
+        detail::gemm::dispatch<detail::gemm::wide_kernel_t<2 * product, detail::gemm::fits_int16_v<SA> && detail::gemm::fits_int16_v<SB>>>(m, n, k, a, lda, b, ldb, c, ldc, shift, threads);
+    }
+} // namespace saturating
@@ -0,0 +1,339 @@
+/**@file
+ * @brief Interleaving and deinterleaving multi-channel data, converting between saturating types on the fly.
+ *
+ * `deinterleave` splits frames of `channels` interleaved values into one array per channel,
+ * `interleave` does the reverse, both converting every value from `SIn` to `SOut` in the same pass:
+ *
+ * - integral to integral: `round(x / 2^shift)`, halfway cases up, saturated to `SOut`.
+ * - integral to floating point: `x * scale` clipped to `SOut`; by default `scale = 2^-digits`, so
+ *   `int_sat16_t` maps onto `-1 ... 1` of `float_sat_t`.
+ * - floating point to integral: `round(x * scale)`, halfway cases to even, saturated to `SOut`, NaN
+ *   becoming zero; by default `scale = 2^digits`, the inverse of the above.
+ * - floating point to floating point: `x * scale` (default 1) clipped to `SOut`, NaN propagating.
+ *
+ * Two, three and four channels are split and merged with constant lane shuffles of whole
+ * registers, other channel counts gather and scatter single values. Like `batch.hpp` this relies on
+ * IEEE arithmetic, don't compile it with `-ffast-math`.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+#include "./types.hpp"
+#include "./simd.hpp"
+#include "./batch.hpp"
+
+namespace saturating {
+    namespace detail::interleave {
+        template <typename SIn, typename SOut>
+        constexpr bool integral_v = batch::detail::is_integral_type_v<SIn> && batch::detail::is_integral_type_v<SOut>;
+
+        template <typename SIn, typename SOut>
+        constexpr bool scaled_v = is_type_v<SIn> && is_type_v<SOut> && !integral_v<SIn, SOut>;
+
+        /** `2^e` computed in `F`, for exponents up to the 64 bits of the widest integral lanes. */
+        template <typename F>
+        constexpr F power_of_two(const int e) noexcept {
+            F r = 1;
+            for (int i = 0; i < e; ++i) r *= 2;
+            return r;
+        }
+
+        /** Conversion of lanes of `SIn` values to `SOut` values, see the file description. */
+        template <typename SIn, typename SOut>
+        struct convert_t {
+            using TI = typename SIn::value_type;
+            using TO = typename SOut::value_type;
+
+            /** Floating point type of the scale, the wider floating point side. */
+            using F = std::conditional_t<!std::is_floating_point_v<TO> || (std::is_floating_point_v<TI> && sizeof(TI) > sizeof(TO)), TI, TO>;
+            /** Scale, or for integral conversions the shift. */
+            using param_t = std::conditional_t<integral_v<SIn, SOut>, unsigned, F>;
+
+            /** Lanes per register of the wider type. */
+            static constexpr std::size_t lanes = simd::lanes<TI, TO>;
+
+            static constexpr param_t default_param() noexcept {
+                if constexpr (integral_v<SIn, SOut>) {
+                    return 0;
+                } else if constexpr (std::is_integral_v<TI>) {
+                    return F{ 1 } / power_of_two<F>(std::numeric_limits<TI>::digits);
+                } else if constexpr (std::is_integral_v<TO>) {
+                    return power_of_two<F>(std::numeric_limits<TO>::digits);
+                } else {
+                    return 1;
+                }
+            }
+
+            explicit convert_t(const param_t param) noexcept : param{ param } {
+                if constexpr (std::is_floating_point_v<TI> && std::is_integral_v<TO>) {
+                    // The limits rounded inwards, so clipped values convert without overflow
+                    lo = static_cast<TI>(SOut::min_val);
+                    if (static_cast<long double>(lo) < static_cast<long double>(SOut::min_val)) lo = std::nextafter(lo, TI{ 0 });
+                    hi = static_cast<TI>(SOut::max_val);
+                    if (static_cast<long double>(hi) > static_cast<long double>(SOut::max_val)) hi = std::nextafter(hi, TI{ 0 });
+                }
+            }
+
+            template <typename V>
+            inline auto operator()(const V& x) const noexcept {
+                constexpr std::size_t N = sizeof(V) / sizeof(TI);
+                if constexpr (integral_v<SIn, SOut>) {
+                    using W = wide_signed_t<TI, TO>;
+                    // Values representable in both lane types, then the limits of `SOut` if narrower
+                    constexpr auto lo = static_cast<TI>(std::max<W>(std::numeric_limits<TI>::lowest(), std::numeric_limits<TO>::lowest()));
+                    constexpr auto hi = static_cast<TI>(std::min<W>(std::numeric_limits<TI>::max(), std::numeric_limits<TO>::max()));
+                    V v = x;
+                    if (param > sizeof(TI) * 8) {
+                        v = V{};
+                    } else if (param > 0) {
+                        const V temp = x >> static_cast<TI>(param - 1);
+                        v = (temp >> 1) + (temp & 1);
+                    }
+                    const auto out = simd::convert<TO>(batch::detail::clip<batch::nan_policy::propagate>(v, lo, hi));
+                    if constexpr (SOut::min_val != std::numeric_limits<TO>::lowest() || SOut::max_val != std::numeric_limits<TO>::max()) {
+                        return batch::detail::clip<batch::nan_policy::propagate>(out, SOut::min_val, SOut::max_val);
+                    } else {
+                        return out;
+                    }
+                } else if constexpr (std::is_integral_v<TI>) {
+                    const auto v = simd::convert<F>(x) * param;
+                    return simd::convert<TO>(batch::detail::clip<batch::nan_policy::propagate>(v, static_cast<F>(SOut::min_val),
+                                                                                               static_cast<F>(SOut::max_val)));
+                } else if constexpr (std::is_integral_v<TO>) {
+                    using I = std::conditional_t<(sizeof(TO) < sizeof(int32_t)), int32_t, TO>;
+                    const V scaled = x * param;
+                    V v = batch::detail::clip<batch::nan_policy::propagate>(scaled == scaled ? scaled : V{}, lo, hi);
+                    // Adding and subtracting 2^(digits - 1) rounds to even below it, larger values are integral
+                    const V big = V{} + static_cast<TI>(uint64_t{ 1 } << (std::numeric_limits<TI>::digits - 1));
+                    const V bias = v < 0 ? -big : big;
+                    v = v < big && v > -big ? (v + bias) - bias : v;
+                    auto out = simd::convert<I, V, N>(v);
+                    if constexpr (std::numeric_limits<TO>::digits > std::numeric_limits<TI>::digits) {
+                        // Beyond the inward rounded limits lie only values beyond the exact ones
+                        using R = decltype(out);
+                        out = simd::convert<simd::mask_lane_t<I>>(scaled > hi) != 0 ? R{} + static_cast<I>(SOut::max_val) : out;
+                        out = simd::convert<simd::mask_lane_t<I>>(scaled < lo) != 0 ? R{} + static_cast<I>(SOut::min_val) : out;
+                    }
+                    return simd::convert<TO>(out);
+                } else {
+                    const auto v = simd::convert<F>(x) * param;
+                    return simd::convert<TO>(batch::detail::clip<batch::nan_policy::propagate>(v, static_cast<F>(SOut::min_val),
+                                                                                               static_cast<F>(SOut::max_val)));
+                }
+            }
+
+            param_t param;
+            TI lo {}, hi {};  //< Floating point to integral clipping limits
+        };
+
+        /** Lane `k` of channel `c`: value `c + C * k` of `C` concatenated interleaved vectors, taken from vector `j`. */
+        template <std::size_t C, std::size_t N, std::size_t c, std::size_t j, std::size_t k>
+        constexpr std::size_t split_index = (c + C * k) / N == j ? N + (c + C * k) % N : k;
+
+        /** Lane `k` of interleaved vector `j`: value `j * N + k`, taken from channel `c`. */
+        template <std::size_t C, std::size_t N, std::size_t j, std::size_t c, std::size_t k>
+        constexpr std::size_t merge_index = (j * N + k) % C == c ? N + (j * N + k) / C : k;
+
+        /** `acc` with the lanes of channel `c` found in vector `j` taken from `v`. */
+        template <std::size_t C, std::size_t c, std::size_t j, typename V, std::size_t... K>
+        inline V split_step(const V& acc, const V& v, std::index_sequence<K...>) noexcept {
+            return simd::shuffle<split_index<C, sizeof...(K), c, j, K>...>(acc, v);
+        }
+
+        /** `acc` with the lanes of interleaved vector `j` found in channel `c` taken from `v`. */
+        template <std::size_t C, std::size_t j, std::size_t c, typename V, std::size_t... K>
+        inline V merge_step(const V& acc, const V& v, std::index_sequence<K...>) noexcept {
+            return simd::shuffle<merge_index<C, sizeof...(K), j, c, K>...>(acc, v);
+        }
+
+        /** Channel `c` of `C` interleaved vectors. */
+        template <std::size_t C, std::size_t c, typename V, std::size_t... J, typename K>
+        inline V split(const V* v, std::index_sequence<J...>, K lanes) noexcept {
+            V acc = v[0];
+            ((acc = split_step<C, c, J>(acc, v[J], lanes)), ...);
+            return acc;
+        }
+
+        /** Interleaved vector `j` of `C` channel vectors. */
+        template <std::size_t C, std::size_t j, typename V, std::size_t... Ch, typename K>
+        inline V merge(const V* v, std::index_sequence<Ch...>, K lanes) noexcept {
+            V acc = v[0];
+            ((acc = merge_step<C, j, Ch>(acc, v[Ch], lanes)), ...);
+            return acc;
+        }
+
+        /** `C` channels, `N` frames per step: `C` vectors loaded, shuffled into `C` channel vectors, converted. */
+        template <std::size_t C, typename SIn, typename SOut, std::size_t... Ch>
+        inline void deinterleave(const SIn* in, SOut* const* out, std::size_t frames, const convert_t<SIn, SOut>& convert,
+                                 std::index_sequence<Ch...> channels) noexcept {
+            using TI = typename SIn::value_type;
+            using TO = typename SOut::value_type;
+            constexpr std::size_t N = convert_t<SIn, SOut>::lanes;
+            const TI* src = batch::detail::values(in);
+            TO* const dst[C] = { batch::detail::values(out[Ch])... };
+
+            simd::vector_t<TI, N> v[C];
+            std::size_t i = 0;
+            for (; i + N <= frames; i += N) {
+                for (std::size_t j = 0; j < C; ++j) v[j] = simd::load<N>(src + i * C + j * N);
+                (simd::store<N>(dst[Ch] + i, convert(split<C, Ch>(v, channels, std::make_index_sequence<N>{}))), ...);
+            }
+            if (i < frames) {
+                TI tail[C * N] = {};
+                std::memcpy(tail, src + i * C, (frames - i) * C * sizeof(TI));
+                for (std::size_t j = 0; j < C; ++j) v[j] = simd::load<N>(tail + j * N);
+                (simd::store_partial<N>(dst[Ch] + i, convert(split<C, Ch>(v, channels, std::make_index_sequence<N>{})), frames - i), ...);
+            }
+        }
+
+        template <std::size_t C, typename SIn, typename SOut, std::size_t... Ch>
+        inline void interleave(const SIn* const* in, SOut* out, std::size_t frames, const convert_t<SIn, SOut>& convert,
+                               std::index_sequence<Ch...> channels) noexcept {
+            using TI = typename SIn::value_type;
+            using TO = typename SOut::value_type;
+            constexpr std::size_t N = convert_t<SIn, SOut>::lanes;
+            const TI* const src[C] = { batch::detail::values(in[Ch])... };
+            TO* dst = batch::detail::values(out);
+
+            simd::vector_t<TO, N> v[C];
+            std::size_t i = 0;
+            for (; i + N <= frames; i += N) {
+                ((v[Ch] = convert(simd::load<N>(src[Ch] + i))), ...);
+                (simd::store<N>(dst + i * C + Ch * N, merge<C, Ch>(v, channels, std::make_index_sequence<N>{})), ...);
+            }
+            if (i < frames) {
+                TO tail[C * N];
+                ((v[Ch] = convert(simd::load_partial<N>(src[Ch] + i, frames - i))), ...);
+                (simd::store<N>(tail + Ch * N, merge<C, Ch>(v, channels, std::make_index_sequence<N>{})), ...);
+                std::memcpy(dst + i * C, tail, (frames - i) * C * sizeof(TO));
+            }
+        }
+
+        /** Any channel count: values gathered into and scattered from vectors of one channel. */
+        template <typename SIn, typename SOut>
+        inline void deinterleave(const SIn* in, std::size_t channels, SOut* const* out, std::size_t frames,
+                                 const convert_t<SIn, SOut>& convert) noexcept {
+            using TI = typename SIn::value_type;
+            constexpr std::size_t N = convert_t<SIn, SOut>::lanes;
+            const TI* src = batch::detail::values(in);
+            for (std::size_t c = 0; c < channels; ++c) {
+                for (std::size_t i = 0; i < frames; i += N) {
+                    const std::size_t count = std::min(N, frames - i);
+                    simd::vector_t<TI, N> v {};
+                    for (std::size_t k = 0; k < count; ++k) v[k] = src[(i + k) * channels + c];
+                    const auto converted = convert(v);
+                    for (std::size_t k = 0; k < count; ++k) batch::detail::values(out[c])[i + k] = converted[k];
+                }
+            }
+        }
+
+        template <typename SIn, typename SOut>
+        inline void interleave(const SIn* const* in, std::size_t channels, SOut* out, std::size_t frames,
+                               const convert_t<SIn, SOut>& convert) noexcept {
+            using TO = typename SOut::value_type;
+            constexpr std::size_t N = convert_t<SIn, SOut>::lanes;
+            TO* dst = batch::detail::values(out);
+            for (std::size_t c = 0; c < channels; ++c) {
+                for (std::size_t i = 0; i < frames; i += N) {
+                    const std::size_t count = std::min(N, frames - i);
+                    const auto converted = convert(simd::load_partial<N>(batch::detail::values(in[c]) + i, count));
+                    for (std::size_t k = 0; k < count; ++k) dst[(i + k) * channels + c] = converted[k];
+                }
+            }
+        }
+
+        template <typename SIn, typename SOut>
+        inline void deinterleave(const SIn* in, std::size_t channels, SOut* const* out, std::size_t frames,
+                                 const typename convert_t<SIn, SOut>::param_t param) noexcept {
+            const convert_t<SIn, SOut> convert { param };
+            switch (channels) {
+                case 1: simd::transform<convert_t<SIn, SOut>::lanes>(convert, batch::detail::values(out[0]), frames, batch::detail::values(in)); break;
+                case 2: deinterleave<2>(in, out, frames, convert, std::make_index_sequence<2>{}); break;
+                case 3: deinterleave<3>(in, out, frames, convert, std::make_index_sequence<3>{}); break;
+                case 4: deinterleave<4>(in, out, frames, convert, std::make_index_sequence<4>{}); break;
+                default: deinterleave(in, channels, out, frames, convert);
+            }
+        }
+
+        template <typename SIn, typename SOut>
+        inline void interleave(const SIn* const* in, std::size_t channels, SOut* out, std::size_t frames,
+                               const typename convert_t<SIn, SOut>::param_t param) noexcept {
+            const convert_t<SIn, SOut> convert { param };
+            switch (channels) {
+                case 1: simd::transform<convert_t<SIn, SOut>::lanes>(convert, batch::detail::values(out), frames, batch::detail::values(in[0])); break;
+                case 2: interleave<2>(in, out, frames, convert, std::make_index_sequence<2>{}); break;
+                case 3: interleave<3>(in, out, frames, convert, std::make_index_sequence<3>{}); break;
+                case 4: interleave<4>(in, out, frames, convert, std::make_index_sequence<4>{}); break;
+                default: interleave(in, channels, out, frames, convert);
+            }
+        }
+    } // namespace detail::interleave
+
+    /**
+     * Split `frames` frames of `channels` interleaved values into one array per channel, converting
+     * each value between floating point and integral types, see the file description.
+     * @param  in       `frames * channels` values, channel `c` of frame `i` at `in[i * channels + c]`
+     * @param  channels Number of channels
+     * @param  out      `channels` arrays of `frames` values
+     * @param  frames   Number of frames
+     * @param  scale    Factor applied before saturating
+     */
+    template <typename SIn, typename SOut>
+    inline std::enable_if_t<detail::interleave::scaled_v<SIn, SOut>>
+    deinterleave(const SIn* in, std::size_t channels, SOut* const* out, std::size_t frames,
+                 const typename detail::interleave::convert_t<SIn, SOut>::F scale = detail::interleave::convert_t<SIn, SOut>::default_param()) noexcept {
+        detail::interleave::deinterleave(in, channels, out, frames, scale);
+    }
+
+    /**
+     * Split interleaved integral values into one array per channel, `round(x / 2^shift)` saturated to `SOut`.
+     * @param  in       `frames * channels` values, channel `c` of frame `i` at `in[i * channels + c]`
+     * @param  channels Number of channels
+     * @param  out      `channels` arrays of `frames` values
+     * @param  frames   Number of frames
+     * @param  shift    Right shift, halfway cases rounding up
+     */
+    template <typename SIn, typename SOut>
+    inline std::enable_if_t<detail::interleave::integral_v<SIn, SOut>>
+    deinterleave(const SIn* in, std::size_t channels, SOut* const* out, std::size_t frames, const unsigned shift = 0) noexcept {
+        detail::interleave::deinterleave(in, channels, out, frames, shift);
+    }
+
+    /**
+     * Merge one array per channel into `frames` frames of `channels` interleaved values, converting
+     * each value between floating point and integral types, see the file description.
+     * @param  in       `channels` arrays of `frames` values
+     * @param  channels Number of channels
+     * @param  out      `frames * channels` values, channel `c` of frame `i` at `out[i * channels + c]`
+     * @param  frames   Number of frames
+     * @param  scale    Factor applied before saturating
+     */
+    template <typename SIn, typename SOut>
+    inline std::enable_if_t<detail::interleave::scaled_v<SIn, SOut>>
+    interleave(const SIn* const* in, std::size_t channels, SOut* out, std::size_t frames,
+               const typename detail::interleave::convert_t<SIn, SOut>::F scale = detail::interleave::convert_t<SIn, SOut>::default_param()) noexcept {
+        detail::interleave::interleave(in, channels, out, frames, scale);
+    }
+
+    /**
+     * Merge integral arrays into interleaved frames, `round(x / 2^shift)` saturated to `SOut`.
+     * @param  in       `channels` arrays of `frames` values
+     * @param  channels Number of channels
+     * @param  out      `frames * channels` values, channel `c` of frame `i` at `out[i * channels + c]`
+     * @param  frames   Number of frames
+     * @param  shift    Right shift, halfway cases rounding up
+     */
+    template <typename SIn, typename SOut>
+    inline std::enable_if_t<detail::interleave::integral_v<SIn, SOut>>
+    interleave(const SIn* const* in, std::size_t channels, SOut* out, std::size_t frames, const unsigned shift = 0) noexcept {
+        detail::interleave::interleave(in, channels, out, frames, shift);
+    }
+} // namespace saturating
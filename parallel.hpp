@@ -0,0 +1,59 @@
+/**@file
+ * @brief Minimal fork / join helpers for the multi-threaded kernels.
+ *
+ * Work is split into contiguous chunks, each processed by its own `std::thread`; the calling thread
+ * takes the first chunk. There is no pool: the kernels using this only go parallel for inputs large
+ * enough to amortize thread creation.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace saturating::parallel {
+    /** Thread count used when a kernel is passed `threads == 0`. */
+    inline unsigned default_threads() noexcept {
+        const unsigned count = std::thread::hardware_concurrency();
+        return count ? count : 1;
+    }
+
+    /**
+     * Number of chunks to split `n` items into, using at most `threads` threads (0 for all cores)
+     * and at least `grain` items per chunk.
+     */
+    inline std::size_t chunk_count(std::size_t n, unsigned threads, std::size_t grain) noexcept {
+        const std::size_t limit = threads ? threads : default_threads();
+        const std::size_t by_size = grain ? n / grain : n;
+        return by_size < 1 ? 1 : (by_size < limit ? by_size : limit);
+    }
+
+    /**
+     * Run `f(chunk, begin, end)` for `chunks` near equal contiguous ranges covering `[0, n)`, in parallel.
+     * Returns when all chunks are done. If a thread cannot be started its chunk runs on the caller.
+     */
+    template <typename F>
+    void for_each_chunk(std::size_t n, std::size_t chunks, F&& f) {
+        const auto begin = [n, chunks](std::size_t chunk) noexcept { return n / chunks * chunk + (chunk < n % chunks ? chunk : n % chunks); };
+        if (chunks <= 1) {
+            f(std::size_t{0}, std::size_t{0}, n);
+            return;
+        }
+
+        std::vector<std::thread> workers;
+        workers.reserve(chunks - 1);
+        for (std::size_t chunk = 1; chunk < chunks; ++chunk) {
+            try {
+                workers.emplace_back([&f, chunk, b = begin(chunk), e = begin(chunk + 1)] { f(chunk, b, e); });
+            } catch (...) {
+                f(chunk, begin(chunk), begin(chunk + 1));
+            }
+        }
+        f(std::size_t{0}, begin(0), begin(1));
+        for (auto& worker : workers) worker.join();
+    }
+} // namespace saturating::parallel
@@ -0,0 +1,219 @@
+/**@file
+ * @brief Fused streaming pipelines of saturating operations.
+ *
+ * A chain like gain -> offset -> clip -> narrow written as separate loops (or `batch` calls) passes
+ * over the whole buffer once per step. A `pipeline::chain` of the same stages processes the data in
+ * blocks small enough to stay in L1: every stage runs over one block before the next block is
+ * loaded, so the buffer is read and written once.
+ *
+ * A stage is any object with `in_type`, `out_type` and `operator()(const in_type*, out_type*, std::size_t)`;
+ * the builders below wrap the `batch` kernels and the scalar `saturating::type` operations. Stages keep the
+ * `noexcept` of what they call, and stateful (`mutable`) callables work in non-const stages and chains.
+ * Chains are stages themselves and can be applied to whole arrays, or `run` between a source and a
+ * sink that produce and consume the data incrementally.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "./types.hpp"
+#include "./batch.hpp"
+
+namespace saturating::pipeline {
+    /**
+     * Size of the block buffers in bytes, several of them should fit in the L1 data cache.
+     * Buffers are uninitialized storage, so stages only see elements written by the previous stage.
+     */
+    constexpr std::size_t block_bytes = 8192;
+
+    /** Stage wrapping the callable `f(const In* in, Out* out, std::size_t n)`. */
+    template <typename In, typename Out, typename F>
+    struct stage {
+        using in_type = In;
+        using out_type = Out;
+
+        F f;
+
+        void operator()(const In* in, Out* out, std::size_t n) noexcept(std::is_nothrow_invocable_v<F&, const In*, Out*, std::size_t>) {
+            f(in, out, n);
+        }
+        void operator()(const In* in, Out* out, std::size_t n) const noexcept(std::is_nothrow_invocable_v<const F&, const In*, Out*, std::size_t>) {
+            f(in, out, n);
+        }
+    };
+
+    template <typename In, typename Out, typename F>
+    constexpr stage<In, Out, std::decay_t<F>> make_stage(F&& f) noexcept(std::is_nothrow_constructible_v<std::decay_t<F>, F&&>) {
+        static_assert(std::is_invocable_v<std::decay_t<F>&, const In*, Out*, std::size_t>,
+                      "A stage callable takes `(const In* in, Out* out, std::size_t n)`");
+        return { std::forward<F>(f) };
+    }
+
+    /** `out[i] = in[i] * gain` */
+    template <typename S, batch::nan_policy P = batch::nan_policy::propagate>
+    constexpr auto gain(const typename S::value_type gain) noexcept {
+        return make_stage<S, S>([gain](const S* in, S* out, std::size_t n) noexcept {
+            if constexpr (std::is_floating_point_v<typename S::value_type>) {
+                batch::multiply<P>(in, gain, out, n);
+            } else {
+                batch::multiply(in, gain, out, n);
+            }
+        });
+    }
+
+    /** `out[i] = in[i] + offset` */
+    template <typename S, batch::nan_policy P = batch::nan_policy::propagate>
+    constexpr auto offset(const typename S::value_type offset) noexcept {
+        return make_stage<S, S>([offset](const S* in, S* out, std::size_t n) noexcept {
+            if constexpr (std::is_floating_point_v<typename S::value_type>) {
+                batch::add<P>(in, offset, out, n);
+            } else {
+                batch::add(in, offset, out, n);
+            }
+        });
+    }
+
+    /** `out[i] = clamp(lo, in[i], hi)`, limits within those of `S` */
+    template <typename S, batch::nan_policy P = batch::nan_policy::propagate>
+    constexpr auto clip(const typename S::value_type lo, const typename S::value_type hi) noexcept {
+        return make_stage<S, S>([lo, hi](const S* in, S* out, std::size_t n) noexcept {
+            batch::clip<P>(in, out, n, lo, hi);
+        });
+    }
+
+    /** `out[i] = SOut::scale_from(in[i])` */
+    template <typename SIn, typename SOut>
+    constexpr auto scale_from() noexcept {
+        return make_stage<SIn, SOut>([](const SIn* in, SOut* out, std::size_t n) noexcept {
+            for (std::size_t i = 0; i < n; ++i) out[i] = SOut::scale_from(in[i]);
+        });
+    }
+
+    /** `out[i] = round(in[i] / 2^shift)`, saturated into `SOut` */
+    template <typename SIn, typename SOut>
+    constexpr auto narrow(const unsigned shift = 0) noexcept {
+        return make_stage<SIn, SOut>([shift](const SIn* in, SOut* out, std::size_t n) noexcept {
+            batch::rounding_shift_right(in, out, n, shift);
+        });
+    }
+
+    /**
+     * `out[i] = f(in[i])`, for operations without a batch kernel. Exceptions of `f` propagate, a
+     * `mutable` callable makes a stage that only runs when not const.
+     */
+    template <typename In, typename Out, typename F>
+    constexpr auto map(F&& f) noexcept(std::is_nothrow_constructible_v<std::decay_t<F>, F&&>) {
+        using G = std::decay_t<F>;
+        if constexpr (std::is_invocable_v<const G&, const In&>) {
+            return make_stage<In, Out>([f = std::forward<F>(f)](const In* in, Out* out, std::size_t n) noexcept(std::is_nothrow_invocable_v<const G&, const In&>) {
+                for (std::size_t i = 0; i < n; ++i) out[i] = f(in[i]);
+            });
+        } else {
+            static_assert(std::is_invocable_v<G&, const In&>, "A map callable takes `const In&`");
+            return make_stage<In, Out>([f = std::forward<F>(f)](const In* in, Out* out, std::size_t n) mutable noexcept(std::is_nothrow_invocable_v<G&, const In&>) {
+                for (std::size_t i = 0; i < n; ++i) out[i] = f(in[i]);
+            });
+        }
+    }
+
+    /** Stages applied one after the other, one block at a time. */
+    template <typename... Stages>
+    class chain_t {
+        static_assert(sizeof...(Stages) > 0, "A chain needs at least one stage");
+
+        template <std::size_t I>
+        using stage_t = std::tuple_element_t<I, std::tuple<Stages...>>;
+
+    public:
+        using in_type = typename stage_t<0>::in_type;
+        using out_type = typename stage_t<sizeof...(Stages) - 1>::out_type;
+
+        /** Elements per block, so a block of the widest type in the chain fills the block buffer. */
+        static constexpr std::size_t block = block_bytes / std::max({ sizeof(typename Stages::in_type)..., sizeof(out_type) });
+
+        constexpr explicit chain_t(Stages... stages) noexcept((std::is_nothrow_move_constructible_v<Stages> && ...)) : stages{ std::move(stages)... } {}
+
+        /** Process `n` elements of `in` into `out`; they may be the same array if the types match. */
+        void operator()(const in_type* in, out_type* out, std::size_t n) noexcept(nothrow_v<Stages&...>) {
+            process(stages, in, out, n);
+        }
+        void operator()(const in_type* in, out_type* out, std::size_t n) const noexcept(nothrow_v<const Stages&...>) {
+            process(stages, in, out, n);
+        }
+
+    private:
+        template <typename... S>
+        static constexpr bool nothrow_v = (std::is_nothrow_invocable_v<S, const typename std::decay_t<S>::in_type*,
+                                                                       typename std::decay_t<S>::out_type*, std::size_t> && ...);
+
+        template <typename Tuple>
+        static void process(Tuple& stages, const in_type* in, out_type* out, std::size_t n) {
+            for (std::size_t i = 0; i < n; i += block) {
+                apply<0>(stages, in + i, out + i, std::min(block, n - i));
+            }
+        }
+
+        // `stages` is the tuple as const as the chain, so that carries over to the stages
+        template <std::size_t I, typename Tuple>
+        static void apply(Tuple& stages, const typename stage_t<I>::in_type* in, out_type* out, std::size_t n) {
+            if constexpr (I + 1 == sizeof...(Stages)) {
+                std::get<I>(stages)(in, out, n);
+            } else {
+                using T = typename stage_t<I>::out_type;
+                static_assert(std::is_same_v<T, typename stage_t<I + 1>::in_type>, "Stage output and next stage input types differ");
+                alignas(64) unsigned char storage[block * sizeof(T)];
+                T* buffer = reinterpret_cast<T*>(storage);
+                std::get<I>(stages)(in, buffer, n);
+                apply<I + 1>(stages, buffer, out, n);
+            }
+        }
+
+        std::tuple<Stages...> stages;
+    };
+
+    /**
+     * Fuse `stages` into one stage; the output type of each must be the input type of the next.
+     * @code
+     *     auto p = pipeline::chain(pipeline::gain<float_sat_t>(0.5f), pipeline::offset<float_sat_t>(0.1f));
+     *     p(in, out, n);
+     * @endcode
+     */
+    template <typename... Stages>
+    constexpr chain_t<Stages...> chain(Stages... stages) noexcept((std::is_nothrow_move_constructible_v<Stages> && ...)) {
+        return chain_t<Stages...>{ std::move(stages)... };
+    }
+
+    /**
+     * Pull blocks from `source`, process them with `stage` and push the results to `sink`, until the
+     * source runs dry.
+     * @param  stage  A stage or chain, called as passed (so a non-const one may keep state)
+     * @param  source `std::size_t(in_type* buffer, std::size_t max)`, fills up to `max` values and
+     *                returns how many; zero ends the stream
+     * @param  sink   `void(const out_type* buffer, std::size_t n)`, consumes `n` results
+     * @return        Number of elements processed
+     */
+    template <typename Stage, typename Source, typename Sink>
+    std::size_t run(Stage&& stage, Source&& source, Sink&& sink) {
+        using In = typename std::decay_t<Stage>::in_type;
+        using Out = typename std::decay_t<Stage>::out_type;
+        constexpr std::size_t block = block_bytes / std::max(sizeof(In), sizeof(Out));
+        alignas(64) unsigned char in_storage[block * sizeof(In)];
+        alignas(64) unsigned char out_storage[block * sizeof(Out)];
+        In* in = reinterpret_cast<In*>(in_storage);
+        Out* out = reinterpret_cast<Out*>(out_storage);
+
+        std::size_t total = 0;
+        for (std::size_t n = source(in, block); n > 0; n = source(in, block)) {
+            stage(in, out, n);
+            sink(static_cast<const Out*>(out), n);
+            total += n;
+        }
+        return total;
+    }
+} // namespace saturating::pipeline
@@ -0,0 +1,165 @@
+/**@file
+ * @brief Affine quantization between floating point values and 8 / 16 bit saturating types.
+ *
+ * `q = clamp(round(x / scale) + zero_point, MIN, MAX)` and `x = (q - zero_point) * scale`, rounding
+ * halfway cases to even. The array kernels give exactly the results of the scalar `quantize` and
+ * `dequantize` functions: all intermediates of up to 16 bit values are exact in `float`, and the
+ * vector rounding (adding and subtracting 1.5 * 2^23 after clipping) rounds to even like the scalar
+ * one. Like `batch.hpp` this relies on IEEE arithmetic, don't compile it with `-ffast-math`.
+ *
+ * Per channel parameters follow the layout `[outer][channels][inner]`: element
+ * `(o * channels + c) * inner + i` uses `scales[c]` and `zero_points[c]`. Channels as the innermost
+ * axis (`inner == 1`) are vectorized over the channels, other layouts over `inner`.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+#include "./types.hpp"
+#include "./simd.hpp"
+#include "./batch.hpp"
+
+namespace saturating {
+    namespace detail::quantize {
+        template <typename F, typename S>
+        constexpr bool supported_v = (std::is_same_v<F, float> || std::is_same_v<F, double>)
+                                     && is_type_v<S> && std::is_integral_v<typename S::value_type>
+                                     && sizeof(typename S::value_type) <= sizeof(int16_t);
+
+        /** Adding and subtracting this rounds any value of magnitude below 2^(digits - 2) to an integral, to even. */
+        template <typename F>
+        constexpr F round_bias = static_cast<F>(3ull << (std::numeric_limits<F>::digits - 2));
+
+        /**
+         * `x / scale` clipped so that adding `zero_point` stays within the limits of `S`, NaN replaced
+         * by zero. Scale and zero point are scalars or one per lane.
+         */
+        template <typename S, typename F, typename V, typename Scale, typename Z>
+        constexpr V scaled(const V& x, const Scale& scale, const Z& zero_point) noexcept {
+            const V quotient = x / scale;
+            const V v = quotient == quotient ? quotient : V{};
+            const auto lo = static_cast<F>(S::min_val) - zero_point;
+            const auto hi = static_cast<F>(S::max_val) - zero_point;
+            return v < lo ? V{} + lo : (v > hi ? V{} + hi : v);
+        }
+
+        /** Vector form of `saturating::quantize`, the zero point converted to `F`. */
+        template <typename S, typename F, typename V, typename Scale, typename Z>
+        inline auto quantize(const V& x, const Scale& scale, const Z& zero_point) noexcept {
+            const V v = scaled<S, F>(x, scale, zero_point);
+            // Through 32 bit lanes, compilers don't vectorize direct floating point to 8 / 16 bit conversions
+            return simd::convert<typename S::value_type>(simd::convert<int32_t>(((v + round_bias<F>) - round_bias<F>) + zero_point));
+        }
+
+        /** `n` consecutive elements sharing one scale and zero point. */
+        template <typename F, typename S>
+        inline void quantize(const F* in, S* out, std::size_t n, const F scale, const typename S::value_type zero_point) noexcept {
+            const F zp = zero_point;
+            simd::transform<simd::lanes<F>>([scale, zp](const auto& x) noexcept {
+                return quantize<S, F>(x, scale, zp);
+            }, batch::detail::values(out), n, in);
+        }
+
+        template <typename F, typename S>
+        inline void dequantize(const S* in, F* out, std::size_t n, const F scale, const typename S::value_type zero_point) noexcept {
+            const F zp = zero_point;
+            simd::transform<simd::lanes<F>>([scale, zp](const auto& q) noexcept {
+                return (simd::convert<F>(q) - zp) * scale;
+            }, out, n, batch::detail::values(in));
+        }
+    } // namespace detail::quantize
+
+    /**
+     * Quantize `x` into `S`: `round(x / scale) + zero_point`, halfway cases to even, saturated to the
+     * limits of `S`. NaN quantizes to `zero_point`.
+     * @param  x          Value
+     * @param  scale      Step size, positive and finite
+     * @param  zero_point Quantized value representing zero
+     */
+    template <typename S, typename F>
+    constexpr std::enable_if_t<detail::quantize::supported_v<F, S>, S> __attribute__((const))
+    quantize(const F x, const F scale, const typename S::value_type zero_point) noexcept {
+        const F zp = zero_point;
+        const F v = detail::quantize::scaled<S, F>(x, scale, zp);
+        return S{ static_cast<typename S::value_type>(round_half_even(v) + zp) };
+    }
+
+    /** Value represented by `q`: `(q - zero_point) * scale`. */
+    template <typename F, typename S>
+    constexpr std::enable_if_t<detail::quantize::supported_v<F, S>, F> __attribute__((const))
+    dequantize(const S q, const F scale, const typename S::value_type zero_point) noexcept {
+        return (static_cast<F>(static_cast<typename S::value_type>(q)) - static_cast<F>(zero_point)) * scale;
+    }
+
+    /**
+     * Quantize `n` values, `out[i] = quantize<S>(in[i], scale, zero_point)`.
+     */
+    template <typename F, typename S>
+    inline std::enable_if_t<detail::quantize::supported_v<F, S>>
+    quantize(const F* in, S* out, std::size_t n, const F scale, const typename S::value_type zero_point) noexcept {
+        detail::quantize::quantize(in, out, n, scale, zero_point);
+    }
+
+    /**
+     * Quantize `outer * channels * inner` values with per channel parameters, see the layout above.
+     * @param  in          Values
+     * @param  out         Quantized values
+     * @param  outer       Number of elements along the axes before the channel axis
+     * @param  channels    Number of channels
+     * @param  inner       Number of elements along the axes after the channel axis
+     * @param  scales      `channels` scales
+     * @param  zero_points `channels` zero points
+     */
+    template <typename F, typename S>
+    inline std::enable_if_t<detail::quantize::supported_v<F, S>>
+    quantize(const F* in, S* out, std::size_t outer, std::size_t channels, std::size_t inner,
+             const F* scales, const typename S::value_type* zero_points) noexcept {
+        using T = typename S::value_type;
+        if (inner == 1) {
+            for (std::size_t o = 0; o < outer; ++o, in += channels, out += channels) {
+                simd::transform<simd::lanes<F>>([](const auto& x, const auto& scale, const auto& zp) noexcept {
+                    return detail::quantize::quantize<S, F>(x, scale, simd::convert<F>(zp));
+                }, batch::detail::values(out), channels, in, scales, zero_points);
+            }
+        } else {
+            for (std::size_t o = 0; o < outer; ++o) {
+                for (std::size_t c = 0; c < channels; ++c, in += inner, out += inner) {
+                    detail::quantize::quantize(in, out, inner, scales[c], static_cast<T>(zero_points[c]));
+                }
+            }
+        }
+    }
+
+    /**
+     * Dequantize `n` values, `out[i] = dequantize(in[i], scale, zero_point)`.
+     */
+    template <typename F, typename S>
+    inline std::enable_if_t<detail::quantize::supported_v<F, S>>
+    dequantize(const S* in, F* out, std::size_t n, const F scale, const typename S::value_type zero_point) noexcept {
+        detail::quantize::dequantize(in, out, n, scale, zero_point);
+    }
+
+    /** Dequantize with per channel parameters, see `quantize` above. */
+    template <typename F, typename S>
+    inline std::enable_if_t<detail::quantize::supported_v<F, S>>
+    dequantize(const S* in, F* out, std::size_t outer, std::size_t channels, std::size_t inner,
+               const F* scales, const typename S::value_type* zero_points) noexcept {
+        if (inner == 1) {
+            for (std::size_t o = 0; o < outer; ++o, in += channels, out += channels) {
+                simd::transform<simd::lanes<F>>([](const auto& q, const auto& scale, const auto& zp) noexcept {
+                    return (simd::convert<F>(q) - simd::convert<F>(zp)) * scale;
+                }, out, channels, batch::detail::values(in), scales, zero_points);
+            }
+        } else {
+            for (std::size_t o = 0; o < outer; ++o) {
+                for (std::size_t c = 0; c < channels; ++c, in += inner, out += inner) {
+                    detail::quantize::dequantize(in, out, inner, scales[c], zero_points[c]);
+                }
+            }
+        }
+    }
+} // namespace saturating
@@ -0,0 +1,248 @@
+/**@file
+ * @brief Sums of absolute and squared differences of 8 and 16 bit blocks.
+ *
+ * `sad` and `ssd` compare two 2D blocks of equal size, the `_map` forms slide one block over every
+ * position of a search area, as in block matching. Sums are exact, returned as `uint64_t` (which
+ * cannot overflow below 2^32 elements), per element differences are those of
+ * `saturating::abs_diff` in a wide type.
+ *
+ * On x86 8 bit rows use `psadbw` (SAD) and `pmaddwd` on widened differences (SSD), signed values
+ * offset by 128 so the unsigned instructions see the same differences. 16 bit values and other
+ * targets use the portable vector extension kernel, accumulating in 32 bit lanes flushed to 64 bits.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include "./types.hpp"
+#include "./simd.hpp"
+#include "./batch.hpp"
+
+namespace saturating {
+    namespace detail::sad {
+        template <typename T>
+        constexpr bool supported_v = std::is_integral_v<T> && !is_type_v<T> && sizeof(T) <= sizeof(int16_t);
+
+        /** Portable row kernel: sum of `|a[i] - b[i]|` (or its square) over `width` elements. */
+        template <bool SQUARE, typename T>
+        inline uint64_t row_generic(const T* a, const T* b, std::size_t width) noexcept {
+            using D = int32_t;  //< Holds any difference of 16 bit values
+            // Squares of 16 bit differences need 64 bit lanes, other terms stay below 2^16
+            using A = std::conditional_t<SQUARE && sizeof(T) == sizeof(int16_t), uint64_t, uint32_t>;
+            constexpr std::size_t N = simd::lanes<A>;
+            constexpr std::size_t flush = std::is_same_v<A, uint32_t> ? (std::size_t{ 1 } << 15) * N : ~std::size_t{ 0 };
+
+            uint64_t total = 0;
+            std::size_t i = 0;
+            while (i + N <= width) {
+                simd::vector_t<A, N> acc {};
+                const std::size_t end = i + min((width - i) / N * N, flush);
+                for (; i < end; i += N) {
+                    const auto d = simd::convert<D>(simd::load<N>(a + i)) - simd::convert<D>(simd::load<N>(b + i));
+                    if constexpr (SQUARE) {
+                        // Modulo 2^bits the square of the wrapped difference equals the true square
+                        const auto u = simd::convert<A>(d);
+                        acc += u * u;
+                    } else {
+                        acc += simd::convert<A>(d < 0 ? -d : d);
+                    }
+                }
+                for (std::size_t j = 0; j < N; ++j) total += acc[j];
+            }
+            for (; i < width; ++i) {
+                const int64_t d = static_cast<int64_t>(a[i]) - b[i];
+                total += static_cast<uint64_t>(SQUARE ? d * d : (d < 0 ? -d : d));
+            }
+            return total;
+        }
+
+#if defined(__SSE2__)
+        /** Offset mapping signed bytes to unsigned ones with the same differences. */
+        template <typename T>
+        inline __m128i bias128() noexcept { return _mm_set1_epi8(std::is_signed_v<T> ? static_cast<char>(0x80) : 0); }
+
+        /** `pmaddwd` of the differences of the 16 bit widened bytes of `x` and `y` with themselves. */
+        inline __m128i square_diff128(__m128i x, __m128i y) noexcept {
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i lo = _mm_sub_epi16(_mm_unpacklo_epi8(x, zero), _mm_unpacklo_epi8(y, zero));
+            const __m128i hi = _mm_sub_epi16(_mm_unpackhi_epi8(x, zero), _mm_unpackhi_epi8(y, zero));
+            return _mm_add_epi32(_mm_madd_epi16(lo, lo), _mm_madd_epi16(hi, hi));
+        }
+
+        inline uint64_t sum64(__m128i v) noexcept {
+            return static_cast<uint64_t>(_mm_cvtsi128_si64(v)) + static_cast<uint64_t>(_mm_cvtsi128_si64(_mm_unpackhi_epi64(v, v)));
+        }
+
+        inline uint64_t sum32(__m128i v) noexcept {
+            const __m128i zero = _mm_setzero_si128();
+            return sum64(_mm_add_epi64(_mm_unpacklo_epi32(v, zero), _mm_unpackhi_epi32(v, zero)));
+        }
+
+#if defined(__AVX2__)
+        inline __m128i fold(__m256i v) noexcept { return _mm_add_epi64(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1)); }
+#endif
+
+        /** x86 row kernel for 8 bit values. */
+        template <bool SQUARE, typename T>
+        inline uint64_t row_x86(const T* a, const T* b, std::size_t width) noexcept {
+            const auto* pa = reinterpret_cast<const unsigned char*>(a);
+            const auto* pb = reinterpret_cast<const unsigned char*>(b);
+            const __m128i bias = bias128<T>();
+            uint64_t total = 0;
+            std::size_t i = 0;
+
+            if constexpr (SQUARE) {
+                // 32 bit lanes gain at most 4 * 255^2 < 2^18 per step
+                constexpr std::size_t flush = 1 << 12;
+                while (i + 16 <= width) {
+                    __m128i acc = _mm_setzero_si128();
+                    const std::size_t end = i + min((width - i) / 16 * 16, flush * 16);
+                    for (; i < end; i += 16) {
+                        const __m128i x = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pa + i)), bias);
+                        const __m128i y = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pb + i)), bias);
+                        acc = _mm_add_epi32(acc, square_diff128(x, y));
+                    }
+                    total += sum32(acc);
+                }
+            } else {
+                __m128i acc = _mm_setzero_si128();
+#if defined(__AVX2__)
+                const __m256i bias256 = _mm256_broadcastsi128_si256(bias);
+                __m256i acc256 = _mm256_setzero_si256();
+                for (; i + 32 <= width; i += 32) {
+                    const __m256i x = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(pa + i)), bias256);
+                    const __m256i y = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(pb + i)), bias256);
+                    acc256 = _mm256_add_epi64(acc256, _mm256_sad_epu8(x, y));
+                }
+                acc = fold(acc256);
+#endif
+                for (; i + 16 <= width; i += 16) {
+                    const __m128i x = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pa + i)), bias);
+                    const __m128i y = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pb + i)), bias);
+                    acc = _mm_add_epi64(acc, _mm_sad_epu8(x, y));
+                }
+                if (i + 8 <= width) {
+                    // The upper halves are equal (zero, biased alike), adding nothing
+                    const __m128i x = _mm_xor_si128(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(pa + i)), bias);
+                    const __m128i y = _mm_xor_si128(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(pb + i)), bias);
+                    acc = _mm_add_epi64(acc, _mm_sad_epu8(x, y));
+                    i += 8;
+                }
+                total = sum64(acc);
+            }
+            return total + row_generic<SQUARE>(a + i, b + i, width - i);
+        }
+#endif
+
+        template <bool SQUARE, typename T>
+        inline uint64_t row(const T* a, const T* b, std::size_t width) noexcept {
+#if defined(__SSE2__)
+            if constexpr (sizeof(T) == 1) return row_x86<SQUARE>(a, b, width);
+#endif
+            return row_generic<SQUARE>(a, b, width);
+        }
+
+        template <bool SQUARE, typename T>
+        inline uint64_t block(const T* a, std::size_t a_stride, const T* b, std::size_t b_stride, std::size_t width, std::size_t height) noexcept {
+            uint64_t total = 0;
+            for (std::size_t r = 0; r < height; ++r) total += row<SQUARE>(a + r * a_stride, b + r * b_stride, width);
+            return total;
+        }
+
+        template <bool SQUARE, typename T>
+        inline void map(const T* block, std::size_t block_stride, const T* area, std::size_t area_stride,
+                        std::size_t width, std::size_t height, std::size_t cols, std::size_t rows, uint64_t* out) noexcept {
+            for (std::size_t y = 0; y < rows; ++y) {
+                for (std::size_t x = 0; x < cols; ++x) {
+                    *out++ = sad::block<SQUARE>(block, block_stride, area + y * area_stride + x, area_stride, width, height);
+                }
+            }
+        }
+    } // namespace detail::sad
+
+    /**
+     * Sum of absolute differences of two `width x height` blocks of 8 or 16 bit values.
+     * @param  a        First block
+     * @param  a_stride Elements between the starts of rows of `a`
+     * @param  b        Second block
+     * @param  b_stride Elements between the starts of rows of `b`
+     * @param  width    Elements per row
+     * @param  height   Number of rows
+     * @return          Sum of `|a - b|`
+     */
+    template <typename T>
+    inline std::enable_if_t<detail::sad::supported_v<T>, uint64_t>
+    sad(const T* a, std::size_t a_stride, const T* b, std::size_t b_stride, std::size_t width, std::size_t height) noexcept {
+        return detail::sad::block<false>(a, a_stride, b, b_stride, width, height);
+    }
+
+    /** Sum of squared differences of two blocks, see `sad`. */
+    template <typename T>
+    inline std::enable_if_t<detail::sad::supported_v<T>, uint64_t>
+    ssd(const T* a, std::size_t a_stride, const T* b, std::size_t b_stride, std::size_t width, std::size_t height) noexcept {
+        return detail::sad::block<true>(a, a_stride, b, b_stride, width, height);
+    }
+
+    /**
+     * Slide a `width x height` block over a search area: `out[y * cols + x]` is the SAD of `block` and
+     * the area block at column `x`, row `y`. The area spans `width + cols - 1` by `height + rows - 1` elements.
+     * @param  block        Block to match
+     * @param  block_stride Elements between the starts of rows of `block`
+     * @param  area         Top left of the search area
+     * @param  area_stride  Elements between the starts of rows of `area`
+     * @param  width        Elements per block row
+     * @param  height       Block rows
+     * @param  cols         Number of horizontal positions
+     * @param  rows         Number of vertical positions
+     * @param  out          `cols * rows` sums
+     */
+    template <typename T>
+    inline std::enable_if_t<detail::sad::supported_v<T>>
+    sad_map(const T* block, std::size_t block_stride, const T* area, std::size_t area_stride,
+            std::size_t width, std::size_t height, std::size_t cols, std::size_t rows, uint64_t* out) noexcept {
+        detail::sad::map<false>(block, block_stride, area, area_stride, width, height, cols, rows, out);
+    }
+
+    /** Sums of squared differences of a block slid over a search area, see `sad_map`. */
+    template <typename T>
+    inline std::enable_if_t<detail::sad::supported_v<T>>
+    ssd_map(const T* block, std::size_t block_stride, const T* area, std::size_t area_stride,
+            std::size_t width, std::size_t height, std::size_t cols, std::size_t rows, uint64_t* out) noexcept {
+        detail::sad::map<true>(block, block_stride, area, area_stride, width, height, cols, rows, out);
+    }
+
+    // Saturating type overloads, on the values
+
+    template <typename S>
+    inline std::enable_if_t<is_type_v<S> && detail::sad::supported_v<typename S::value_type>, uint64_t>
+    sad(const S* a, std::size_t a_stride, const S* b, std::size_t b_stride, std::size_t width, std::size_t height) noexcept {
+        return sad(batch::detail::values(a), a_stride, batch::detail::values(b), b_stride, width, height);
+    }
+
+    template <typename S>
+    inline std::enable_if_t<is_type_v<S> && detail::sad::supported_v<typename S::value_type>, uint64_t>
+    ssd(const S* a, std::size_t a_stride, const S* b, std::size_t b_stride, std::size_t width, std::size_t height) noexcept {
+        return ssd(batch::detail::values(a), a_stride, batch::detail::values(b), b_stride, width, height);
+    }
+
+    template <typename S>
+    inline std::enable_if_t<is_type_v<S> && detail::sad::supported_v<typename S::value_type>>
+    sad_map(const S* block, std::size_t block_stride, const S* area, std::size_t area_stride,
+            std::size_t width, std::size_t height, std::size_t cols, std::size_t rows, uint64_t* out) noexcept {
+        sad_map(batch::detail::values(block), block_stride, batch::detail::values(area), area_stride, width, height, cols, rows, out);
+    }
+
+    template <typename S>
+    inline std::enable_if_t<is_type_v<S> && detail::sad::supported_v<typename S::value_type>>
+    ssd_map(const S* block, std::size_t block_stride, const S* area, std::size_t area_stride,
+            std::size_t width, std::size_t height, std::size_t cols, std::size_t rows, uint64_t* out) noexcept {
+        ssd_map(batch::detail::values(block), block_stride, batch::detail::values(area), area_stride, width, height, cols, rows, out);
+    }
+} // namespace saturating
@@ -0,0 +1,197 @@
+/**@file
+ * @brief Parallel prefix sums of integral saturating types.
+ *
+ * Saturating addition is not associative, so splitting a running sum over threads normally changes
+ * the result. The default `sequential` policy still reproduces a loop of `+=` exactly: one step
+ * `s -> clamp(s + x, MIN, MAX)` and any chain of them has the form `s -> clamp(s + offset, lo, hi)`,
+ * so each thread first reduces its chunk to such a function, the chunk start values follow from
+ * applying them in order, and then every chunk is scanned from its start value in parallel.
+ *
+ * The `wide` policy keeps the partial sums exact and only saturates each output, which is cheaper
+ * but matches `+=` only while no partial sum leaves the range of the type.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "./types.hpp"
+#include "./parallel.hpp"
+
+namespace saturating {
+    /** How partial sums of a scan are saturated. */
+    enum class scan_policy {
+        sequential,  //< Every partial sum is saturated, identical to a loop of `+=`
+        wide         //< Partial sums are exact, only the outputs are saturated
+    };
+
+    namespace detail::scan {
+        /** Elements per chunk below which more threads don't pay off. */
+        constexpr std::size_t grain = 1 << 16;
+
+        /** Plain value type of an element (`std::decay` unwraps saturating types). */
+        template <typename U>
+        using value_t = std::decay_t<U>;
+
+        /** Integral holding every sum of a saturated value and an element, and the width of the range. */
+        template <typename S, typename U>
+        using wide_t = wide_signed_t<typename S::value_type, value_t<U>>;
+
+        /** The function `s -> clamp(s + offset, lo, hi)` for `s` within the limits of `S`. */
+        template <typename S, typename U>
+        struct step {
+            using W = wide_t<S, U>;
+            // Offsets beyond the width of the range saturate any input, so they are capped to keep `W` enough
+            static constexpr W range = static_cast<W>(S::max_val) - static_cast<W>(S::min_val);
+
+            W offset = 0;
+            W lo = S::min_val;
+            W hi = S::max_val;
+
+            /** Follow this function by adding `x`. */
+            constexpr void add(const W x) noexcept {
+                offset = clamp(-range, offset + x, range);
+                lo = clamp(static_cast<W>(S::min_val), lo + x, static_cast<W>(S::max_val));
+                hi = clamp(static_cast<W>(S::min_val), hi + x, static_cast<W>(S::max_val));
+            }
+
+            constexpr W operator()(const W s) const noexcept {
+                return clamp(lo, s + offset, hi);
+            }
+        };
+
+        /**
+         * Scan `n` elements starting from `init`, every partial sum saturated (`P == sequential`)
+         * or exact. Exclusive scans store the sum before adding each element.
+         */
+        template <scan_policy P, bool EXCLUSIVE, typename U, typename S, typename A>
+        inline A run(const U* in, S* out, std::size_t n, A acc) noexcept {
+            using T = typename S::value_type;
+            constexpr A lo = S::min_val;
+            constexpr A hi = S::max_val;
+            constexpr bool full_range = std::is_same_v<value_t<U>, T>
+                                        && S::min_val == std::numeric_limits<T>::lowest()
+                                        && S::max_val == std::numeric_limits<T>::max();
+            for (std::size_t i = 0; i < n; ++i) {
+                const A x = static_cast<A>(static_cast<value_t<U>>(in[i]));
+                if constexpr (P == scan_policy::sequential) {
+                    if constexpr (EXCLUSIVE) out[i] = S{ static_cast<T>(acc) };
+                    if constexpr (full_range) {
+                        // Shorter dependency chain than clamping the wide sum
+                        T sum = 0;
+                        acc = __builtin_add_overflow(static_cast<T>(acc), static_cast<T>(x), &sum) ? (x < 0 ? lo : hi) : sum;
+                    } else {
+                        acc = clamp(lo, acc + x, hi);
+                    }
+                    if constexpr (!EXCLUSIVE) out[i] = S{ static_cast<T>(acc) };
+                } else {
+                    if constexpr (EXCLUSIVE) out[i] = S{ static_cast<T>(clamp(lo, acc, hi)) };
+                    acc += x;
+                    if constexpr (!EXCLUSIVE) out[i] = S{ static_cast<T>(clamp(lo, acc, hi)) };
+                }
+            }
+            return acc;
+        }
+
+        /** Scan with accumulator type `A`, in chunks reduced in parallel, then scanned in parallel. */
+        template <scan_policy P, bool EXCLUSIVE, typename A, typename U, typename S>
+        void chunked(const U* in, S* out, std::size_t n, const S& init, unsigned threads) {
+            using W = wide_t<S, U>;
+            const std::size_t chunks = parallel::chunk_count(n, threads, grain);
+            if (chunks <= 1) {
+                run<P, EXCLUSIVE>(in, out, n, static_cast<A>(init));
+                return;
+            }
+
+            // Reduce every chunk but the last, then run the chunks from their start values
+            std::unique_ptr<std::conditional_t<P == scan_policy::sequential, step<S, U>, A>[]> reduced {
+                new std::conditional_t<P == scan_policy::sequential, step<S, U>, A>[chunks - 1]()
+            };
+            std::unique_ptr<A[]> start { new A[chunks] };
+            parallel::for_each_chunk(n, chunks, [&](std::size_t chunk, std::size_t begin, std::size_t end) noexcept {
+                if (chunk + 1 == chunks) return;
+                auto& r = reduced[chunk];
+                for (std::size_t i = begin; i < end; ++i) {
+                    const W x = static_cast<W>(static_cast<value_t<U>>(in[i]));
+                    if constexpr (P == scan_policy::sequential) {
+                        r.add(x);
+                    } else {
+                        r += x;
+                    }
+                }
+            });
+
+            start[0] = static_cast<A>(init);
+            for (std::size_t chunk = 1; chunk < chunks; ++chunk) {
+                if constexpr (P == scan_policy::sequential) {
+                    start[chunk] = reduced[chunk - 1](start[chunk - 1]);
+                } else {
+                    start[chunk] = start[chunk - 1] + reduced[chunk - 1];
+                }
+            }
+
+            parallel::for_each_chunk(n, chunks, [&](std::size_t chunk, std::size_t begin, std::size_t end) noexcept {
+                run<P, EXCLUSIVE>(in + begin, out + begin, end - begin, start[chunk]);
+            });
+        }
+
+        template <scan_policy P, bool EXCLUSIVE, typename U, typename S>
+        void dispatch(const U* in, S* out, std::size_t n, const S& init, unsigned threads) {
+            static_assert(std::is_integral_v<typename S::value_type> && std::is_integral_v<value_t<U>> && sizeof(value_t<U>) <= sizeof(int64_t),
+                          "scan requires integral saturating output and integral input types");
+            using W = wide_t<S, U>;
+            if constexpr (P == scan_policy::wide && std::is_same_v<W, int64_t>) {
+                // Exact sums of 32 bit values need 128 bits only beyond 2^31 elements
+                if (n >= (std::size_t{ 1 } << 31)) {
+                    chunked<P, EXCLUSIVE, wide_signed_t<int64_t>>(in, out, n, init, threads);
+                    return;
+                }
+            }
+            chunked<P, EXCLUSIVE, W>(in, out, n, init, threads);
+        }
+    } // namespace detail::scan
+
+    /**
+     * Running sums `out[i] = in[0] + ... + in[i]` into saturating type `S`, in parallel.
+     * With the `sequential` policy the results are those of `S acc = in[0]; acc += in[1]; ...`.
+     * `in` and `out` may be the same array. May throw `std::bad_alloc` when running in parallel.
+     * @param  in      Integral values or integral saturating types
+     * @param  out     Results
+     * @param  n       Number of elements
+     * @param  threads Maximum number of threads, 0 to use all cores
+     */
+    template <scan_policy P = scan_policy::sequential, typename U, typename S>
+    std::enable_if_t<is_type_v<S>>
+    inclusive_scan(const U* in, S* out, std::size_t n, unsigned threads = 0) {
+        if constexpr (P == scan_policy::wide) {
+            detail::scan::dispatch<P, false>(in, out, n, S{ 0 }, threads);
+        } else if (n > 0) {
+            // The limits may exclude zero, so the first element is the start value rather than `0 + in[0]`
+            using W = detail::scan::wide_t<S, U>;
+            const S first { static_cast<typename S::value_type>(clamp(static_cast<W>(S::min_val),
+                                                                      static_cast<W>(static_cast<detail::scan::value_t<U>>(in[0])),
+                                                                      static_cast<W>(S::max_val))) };
+            out[0] = first;
+            detail::scan::dispatch<P, false>(in + 1, out + 1, n - 1, first, threads);
+        }
+    }
+
+    /** Running sums `out[i] = init + in[0] + ... + in[i]`, see `inclusive_scan` above. */
+    template <scan_policy P = scan_policy::sequential, typename U, typename S>
+    std::enable_if_t<is_type_v<S>>
+    inclusive_scan(const U* in, S* out, std::size_t n, const S& init, unsigned threads = 0) {
+        detail::scan::dispatch<P, false>(in, out, n, init, threads);
+    }
+
+    /** Running sums `out[i] = init + in[0] + ... + in[i - 1]`, see `inclusive_scan` above. */
+    template <scan_policy P = scan_policy::sequential, typename U, typename S>
+    std::enable_if_t<is_type_v<S>>
+    exclusive_scan(const U* in, S* out, std::size_t n, const S& init, unsigned threads = 0) {
+        detail::scan::dispatch<P, true>(in, out, n, init, threads);
+    }
+} // namespace saturating
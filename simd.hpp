@@ -0,0 +1,120 @@
+/**@file
+ * @brief Minimal portable SIMD layer for the batch kernels.
+ *
+ * Built on the GCC / Clang vector extensions, so the same kernel source compiles to SSE, AVX or NEON
+ * depending on the target flags. Kernels are written once against `vector_t` and are applied to
+ * arrays with `transform`, which also handles the tail that does not fill a whole register.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+namespace saturating::simd {
+    /** Register width the kernels are tuned for, in bytes. */
+#if defined(__AVX512BW__)
+    constexpr std::size_t register_bytes = 64;
+#elif defined(__AVX2__)
+    constexpr std::size_t register_bytes = 32;
+#else
+    constexpr std::size_t register_bytes = 16;
+#endif
+
+    template <typename T, std::size_t N>
+    struct vector {
+        static_assert(std::is_arithmetic_v<T> && sizeof(T) <= 8, "Vector lanes must be plain arithmetic types");
+        typedef T type __attribute__((vector_size(N * sizeof(T))));
+    };
+
+    /** A vector of `N` lanes of `T`. */
+    template <typename T, std::size_t N>
+    using vector_t = typename vector<T, N>::type;
+
+    /** Signed integral lane type of the same size as `T`, the type of comparison results. */
+    template <typename T>
+    using mask_lane_t = std::conditional_t<sizeof(T) == 1, int8_t,
+                        std::conditional_t<sizeof(T) == 2, int16_t,
+                        std::conditional_t<sizeof(T) == 4, int32_t, int64_t>>>;
+
+    /** Lanes per operation so that the widest of `T...` fills one register. */
+    template <typename... T>
+    constexpr std::size_t lanes = register_bytes / std::max({ sizeof(T)... });
+
+    template <std::size_t N, typename T>
+    inline vector_t<T, N> load(const T* src) noexcept {
+        vector_t<T, N> v;
+        std::memcpy(&v, src, sizeof(v));
+        return v;
+    }
+
+    /** Load `count < N` elements, the remaining lanes are zero. */
+    template <std::size_t N, typename T>
+    inline vector_t<T, N> load_partial(const T* src, std::size_t count) noexcept {
+        vector_t<T, N> v {};
+        std::memcpy(&v, src, count * sizeof(T));
+        return v;
+    }
+
+    template <std::size_t N, typename T>
+    inline void store(T* dst, const vector_t<T, N>& v) noexcept {
+        std::memcpy(dst, &v, sizeof(v));
+    }
+
+    template <std::size_t N, typename T>
+    inline void store_partial(T* dst, const vector_t<T, N>& v, std::size_t count) noexcept {
+        std::memcpy(dst, &v, count * sizeof(T));
+    }
+
+    template <std::size_t N, typename T>
+    constexpr vector_t<T, N> broadcast(const T& val) noexcept {
+        return vector_t<T, N>{} + val;
+    }
+
+    /** Lane wise conversion, values must fit the destination lane type. */
+    template <typename TOut, typename T, std::size_t N = sizeof(T) / sizeof(T{}[0])>
+    constexpr vector_t<TOut, N> convert(const T& v) noexcept {
+        return __builtin_convertvector(v, vector_t<TOut, N>);
+    }
+
+    /**
+     * Lanes of `a` and `b` picked by the constant indices `I...`, lanes of `b` numbered on from those of `a`.
+     * Compiles to the permute and blend instructions of the target.
+     */
+    template <std::size_t... I, typename V>
+    constexpr V shuffle(const V& a, const V& b) noexcept {
+        static_assert(sizeof...(I) == sizeof(V) / sizeof(a[0]), "One index per lane");
+#if defined(__clang__) || __GNUC__ >= 12
+        return __builtin_shufflevector(a, b, static_cast<int>(I)...);
+#else
+        using M = vector_t<mask_lane_t<std::decay_t<decltype(a[0])>>, sizeof...(I)>;
+        return __builtin_shuffle(a, b, M{ static_cast<mask_lane_t<std::decay_t<decltype(a[0])>>>(I)... });
+#endif
+    }
+
+    /**
+     * Apply the vector kernel `f` to `n` elements: `out[i] = f(in[i]...)`, `N` lanes at a time.
+     * `f` receives one `vector_t<TIn, N>` per input and returns a `vector_t<TOut, N>`.
+     * The tail is processed with zero padded registers. Inputs may alias `out`.
+     */
+    template <std::size_t N, typename TOut, typename F, typename... TIn>
+    inline void transform(F&& f, TOut* out, std::size_t n, const TIn*... in) noexcept {
+        std::size_t i = 0;
+        for (; i + N <= n; i += N) {
+            store<N>(out + i, f(load<N>(in + i)...));
+        }
+        if (i < n) {
+            store_partial<N>(out + i, f(load_partial<N>(in + i, n - i)...), n - i);
+        }
+    }
+
+    /** `transform` with the lane count picked to fill one register for the widest type. */
+    template <typename TOut, typename F, typename... TIn>
+    inline void transform(F&& f, TOut* out, std::size_t n, const TIn*... in) noexcept {
+        transform<lanes<TOut, TIn...>>(std::forward<F>(f), out, n, in...);
+    }
+} // namespace saturating::simd
@@ -17,29 +17,19 @@ namespace std {
     };
 
     template <typename T, T _min, T _max>
-    struct is_unsigned<saturating::type<T, _min, _max>> {
-        static constexpr decltype(auto) value = is_unsigned_v<T>;
-    };
+    struct is_unsigned<saturating::type<T, _min, _max>> : bool_constant<is_unsigned_v<T>> {};
 
     template <typename T, T _min, T _max>
-    struct is_signed<saturating::type<T, _min, _max>> {
-        static constexpr decltype(auto) value = is_signed_v<T>;
-    };
+    struct is_signed<saturating::type<T, _min, _max>> : bool_constant<is_signed_v<T>> {};
 
     template <typename T, T _min, T _max>
-    struct is_integral<saturating::type<T, _min, _max>> {
-        static constexpr decltype(auto) value = is_integral_v<T>;
-    };
+    struct is_integral<saturating::type<T, _min, _max>> : bool_constant<is_integral_v<T>> {};
 
     template <typename T, T _min, T _max>
-    struct is_floating_point<saturating::type<T, _min, _max>> {
-        static constexpr decltype(auto) value = is_floating_point_v<T>;
-    };
+    struct is_floating_point<saturating::type<T, _min, _max>> : bool_constant<is_floating_point_v<T>> {};
 
     template <typename T, T _min, T _max>
-    struct is_arithmetic<saturating::type<T, _min, _max>> {
-        static constexpr decltype(auto) value = is_arithmetic_v<T>;
-    };
+    struct is_arithmetic<saturating::type<T, _min, _max>> : bool_constant<is_arithmetic_v<T>> {};
 
     template <typename T, T _min, T _max>
     class numeric_limits<saturating::type<T, _min, _max>> {
@@ -78,4 +78,11 @@ int main() {
     auto end = std::chrono::system_clock::now();
     auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
     std::cout << "Addition took " << elapsed.count() << " ms" << std::endl;
+
+    // Signed overflow saturates towards the sign of the right hand side, whichever operand is larger
+    assert(saturating::add<int8_t>(int8_t{ -50 }, int8_t{ -100 }) == std::numeric_limits<int8_t>::lowest());
+    assert(saturating::add<int32_t>(-2'000'000'000, -2'000'000'000) == std::numeric_limits<int32_t>::lowest());
+    assert(saturating::add<int32_t>(2'000'000'000, 2'000'000'000) == std::numeric_limits<int32_t>::max());
+    assert(saturating::add<int64_t>(int64_t{ -5 }, std::numeric_limits<int64_t>::lowest()) == std::numeric_limits<int64_t>::lowest());
+    assert(saturating::add<int64_t>(std::numeric_limits<int64_t>::max(), int64_t{ 5 }) == std::numeric_limits<int64_t>::max());
 }
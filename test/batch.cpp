@@ -0,0 +1,93 @@
+#include <iostream>
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <limits>
+#include <vector>
+#include "../types.hpp"
+#include "../batch.hpp"
+
+using saturating::batch::nan_policy;
+
+template <nan_policy P, typename T>
+T reference_clip(const T x, const T lo, const T hi) {
+    if (std::isnan(x)) {
+        if constexpr (P == nan_policy::flush_to_zero) {
+            return std::clamp(T{0}, lo, hi);
+        } else if constexpr (P == nan_policy::saturate) {
+            return std::signbit(x) ? lo : hi;
+        } else {
+            return x;
+        }
+    }
+    return std::clamp(x, lo, hi);
+}
+
+template <typename T>
+bool same(const T a, const T b) {
+    return (std::isnan(a) && std::isnan(b)) || a == b;
+}
+
+template <nan_policy P, typename T>
+void test_floating(std::mt19937_64& rng, const std::size_t n, const T lo, const T hi) {
+    std::uniform_real_distribution<T> dis(-4, 4);
+    std::vector<T> a(n), b(n), out(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        a[i] = dis(rng);
+        b[i] = dis(rng);
+        if (i % 7 == 3) a[i] = std::numeric_limits<T>::quiet_NaN();
+        if (i % 11 == 5) a[i] = -std::numeric_limits<T>::quiet_NaN();
+        if (i % 13 == 1) b[i] = std::numeric_limits<T>::infinity();
+    }
+
+    saturating::batch::clip<P>(a.data(), out.data(), n, lo, hi);
+    for (std::size_t i = 0; i < n; ++i) assert(same(out[i], reference_clip<P>(a[i], lo, hi)));
+    saturating::batch::add<P>(a.data(), b.data(), out.data(), n, lo, hi);
+    for (std::size_t i = 0; i < n; ++i) assert(same(out[i], reference_clip<P>(a[i] + b[i], lo, hi)));
+    saturating::batch::subtract<P>(a.data(), b.data(), out.data(), n, lo, hi);
+    for (std::size_t i = 0; i < n; ++i) assert(same(out[i], reference_clip<P>(a[i] - b[i], lo, hi)));
+    saturating::batch::multiply<P>(a.data(), b.data(), out.data(), n, lo, hi);
+    for (std::size_t i = 0; i < n; ++i) assert(same(out[i], reference_clip<P>(a[i] * b[i], lo, hi)));
+    saturating::batch::multiply<P>(a.data(), T{3}, out.data(), n, lo, hi);
+    for (std::size_t i = 0; i < n; ++i) assert(same(out[i], reference_clip<P>(a[i] * 3, lo, hi)));
+}
+
+template <typename S>
+void test_type(std::mt19937_64& rng, const std::size_t n) {
+    using T = typename S::value_type;
+    std::uniform_real_distribution<T> dis(-2, 2);
+    std::vector<S> a(n), b(n), out(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        a[i] = S{ dis(rng) };
+        b[i] = S{ dis(rng) };
+    }
+    saturating::batch::add(a.data(), b.data(), out.data(), n);
+    for (std::size_t i = 0; i < n; ++i) assert(out[i] == saturating::add<T>(T{a[i]}, T{b[i]}));
+    saturating::batch::multiply(a.data(), b.data(), out.data(), n);
+    for (std::size_t i = 0; i < n; ++i) assert(out[i] == saturating::multiply<T>(T{a[i]}, T{b[i]}));
+    saturating::batch::clip(a.data(), a.data(), n);
+    for (std::size_t i = 0; i < n; ++i) assert(a[i] >= -1 && a[i] <= 1);
+}
+
+int main() {
+    const unsigned samples = 2'000;
+    std::mt19937_64 rng(28);
+
+    auto start = std::chrono::system_clock::now();
+    for (unsigned i = 0; i <= samples; ++i) {
+        const std::size_t n = i % 67;
+        test_floating<nan_policy::propagate, float>(rng, n, -1.0f, 1.0f);
+        test_floating<nan_policy::flush_to_zero, float>(rng, n, 0.25f, 0.75f);
+        test_floating<nan_policy::saturate, float>(rng, n, -0.5f, 2.5f);
+        test_floating<nan_policy::propagate, double>(rng, n, -1.5, 0.5);
+        test_floating<nan_policy::flush_to_zero, double>(rng, n, -1.0, 1.0);
+        test_floating<nan_policy::saturate, double>(rng, n, -1.0, 1.0);
+        test_type<float_sat_t>(rng, n);
+        test_type<double_sat_t>(rng, n);
+    }
+    auto end = std::chrono::system_clock::now();
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+    std::cout << "Batch floating point took " << elapsed.count() << " ms" << std::endl;
+}
@@ -0,0 +1,124 @@
+#include <iostream>
+#include <cassert>
+#include <chrono>
+#include <cstring>
+#include <random>
+#include <limits>
+#include <string>
+#include "../types.hpp"
+#include "../charconv.hpp"
+
+template <typename T>
+void test_parse(const char* text, typename T::value_type expected, bool saturated) {
+    T out;
+    const auto res = saturating::from_chars(text, text + std::strlen(text), out);
+    if (res.ec != std::errc{} || out != expected || res.saturated != saturated || res.ptr != text + std::strlen(text)) {
+        std::cout << "Error parsing \"" << text << "\" ("
+                  << +T::min_val << "..." << +T::max_val << "): got "
+                  << +static_cast<typename T::value_type>(out)
+                  << ", expected " << +expected
+                  << (res.saturated ? " (saturated)" : "") << std::endl;
+        assert(out == expected);
+        assert(res.saturated == saturated);
+    }
+}
+
+template <typename T>
+void test_round_trip(const typename T::value_type& val) {
+    char buf[64];
+    const T in { val };
+    const auto res = saturating::to_chars(buf, buf + sizeof(buf), in);
+    assert(res.ec == std::errc{});
+    T out;
+    const auto back = saturating::from_chars(buf, res.ptr, out);
+    assert(back.ec == std::errc{} && back.ptr == res.ptr && !back.saturated);
+    assert(out == in);
+}
+
+int main() {
+    test_parse<int_sat8_t>("127", 127, false);
+    test_parse<int_sat8_t>("128", 127, true);
+    test_parse<int_sat8_t>("-129", -128, true);
+    test_parse<int_sat8_t>("+12", 12, false);
+    test_parse<uint_sat8_t>("-1", 0, true);
+    test_parse<uint_sat8_t>("-0", 0, false);
+    test_parse<uint_sat8_t>("-99999999999999999999999", 0, true);
+    test_parse<int_sat32_t>("99999999999999999999999", std::numeric_limits<int32_t>::max(), true);
+    test_parse<int_sat64_t>("-99999999999999999999999", std::numeric_limits<int64_t>::lowest(), true);
+    test_parse<uint_sat64_t>("18446744073709551615", std::numeric_limits<uint64_t>::max(), false);
+    test_parse<saturating::type<int8_t, 16, 32>>("5", 16, true);
+    test_parse<saturating::type<int8_t, 16, 32>>("1000", 32, true);
+    test_parse<float_sat_t>("0.5", 0.5f, false);
+    test_parse<float_sat_t>("-3.25", -1.0f, true);
+    test_parse<double_sat_t>("1e999", 1.0, true);
+    test_parse<double_sat_t>("-1e999", -1.0, true);
+    test_parse<double_sat_t>("1e-999", 0.0, false);
+
+    {
+        int_sat16_t out { 42 };
+        const char text[] = "abc";
+        const auto res = saturating::from_chars(text, text + 3, out);
+        assert(res.ec == std::errc::invalid_argument && res.ptr == text && out == 42);
+    }
+
+    {
+        // A single leading `+` only, followed by a number; on error `ptr` is the `+` itself, like `std::from_chars`
+        int_sat16_t i { 42 };
+        double_sat_t d { 0.5 };
+        for (const char* text : { "+-5", "++5", "+-0.5", "+", "+x", "+ 5", "+-" }) {
+            const auto res = saturating::from_chars(text, text + std::strlen(text), i);
+            assert(res.ec == std::errc::invalid_argument && res.ptr == text && i == 42);
+            const auto fres = saturating::from_chars(text, text + std::strlen(text), d);
+            assert(fres.ec == std::errc::invalid_argument && fres.ptr == text && d == 0.5);
+        }
+    }
+
+    {
+        // In hexadecimal `e` is a digit, the exponent follows `p`
+        double_sat_t out { 0.5 };
+        const char tiny[] = "1ep-2000";
+        auto res = saturating::from_chars(tiny, tiny + 8, out, std::chars_format::hex);
+        assert(res.ec == std::errc{} && res.ptr == tiny + 8 && out == 0.0 && !res.saturated);
+        const char huge[] = "-1ep+2000";
+        res = saturating::from_chars(huge, huge + 9, out, std::chars_format::hex);
+        assert(res.ec == std::errc{} && out == -1.0 && res.saturated);
+    }
+
+    {
+        const std::string csv = "1, 2.5, 300\n-7,-9,70000\r\n\n 40000 ,0.25,-1\n";
+        int_sat16_t a[4];
+        float_sat_t b[4];
+        uint_sat16_t c[4];
+        const auto res = saturating::parse_delimited(csv.data(), csv.data() + csv.size(), ',', 4, a, b, c);
+        assert(res.ec == std::errc{});
+        assert(res.rows == 3);
+        assert(res.ptr == csv.data() + csv.size());
+        assert(res.saturated == 5);
+        assert(a[0] == 1 && a[1] == -7 && a[2] == 32767);
+        assert(b[0] == 1.0f && b[1] == -1.0f && b[2] == 0.25f);
+        assert(c[0] == 300 && c[1] == 65535 && c[2] == 0);
+
+        const std::string bad = "1\t2\n3\tx\n";
+        const auto err = saturating::parse_delimited(bad.data(), bad.data() + bad.size(), '\t', 4, a, c);
+        assert(err.ec == std::errc::invalid_argument);
+        assert(err.rows == 1);
+        assert(*err.ptr == 'x');
+    }
+
+    const unsigned samples = 1'000'000;
+    std::mt19937_64 rng(26);
+
+    auto start = std::chrono::system_clock::now();
+    for (unsigned i = 0; i <= samples; ++i) {
+        const auto r = rng();
+        test_round_trip<int_sat8_t>(static_cast<int8_t>(r));
+        test_round_trip<uint_sat16_t>(static_cast<uint16_t>(r));
+        test_round_trip<int_sat32_t>(static_cast<int32_t>(r));
+        test_round_trip<int_sat64_t>(static_cast<int64_t>(r));
+        test_round_trip<uint_sat64_t>(r);
+        test_round_trip<double_sat_t>(static_cast<double>(static_cast<int64_t>(r)) / std::numeric_limits<int64_t>::max());
+    }
+    auto end = std::chrono::system_clock::now();
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+    std::cout << "Character conversion took " << elapsed.count() << " ms" << std::endl;
+}
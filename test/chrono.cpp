@@ -0,0 +1,142 @@
+#include <iostream>
+#include <cassert>
+#include <chrono>
+#include <random>
+#include <limits>
+#include <vector>
+#include "../types.hpp"
+#include "../chrono.hpp"
+
+using namespace std::chrono_literals;
+
+static_assert(saturating::milliseconds::max() + saturating::milliseconds{ 1 } == saturating::milliseconds::max());
+static_assert(saturating::seconds::min() - 1s == saturating::seconds::min());
+static_assert(saturating::nanoseconds{ saturating::hours::max() } == saturating::nanoseconds::max());
+static_assert(saturating::duration_cast<saturating::seconds>(1999ms) == 1s);
+static_assert(saturating::duration_cast<saturating::seconds>(-1999ms) == -1s);
+static_assert(saturating::duration_cast<std::chrono::duration<int8_t>>(saturating::minutes{ 3 }).count() == 127);
+static_assert(saturating::milliseconds{ 5 } + 3s == 3005ms);
+static_assert(saturating::hours::max() > saturating::nanoseconds::max());
+static_assert(saturating::milliseconds::max() != saturating::nanoseconds::max());
+static_assert(-saturating::seconds::min() == saturating::seconds::max());
+static_assert(saturating::seconds{ 7 } / saturating::seconds{ 0 } == std::numeric_limits<int64_t>::max());
+static_assert(saturating::seconds{ 7 } % 2s == 1s);
+static_assert(saturating::duration<uint32_t>{ 3 } - saturating::duration<uint32_t>{ 5 } == saturating::duration<uint32_t>::zero());
+static_assert(saturating::duration<int32_t, std::milli>{ int64_t{ 1 } << 40 } == saturating::duration<int32_t, std::milli>::max());
+
+using wide = __int128;
+
+template <typename T>
+T saturate(const wide val) {
+    return val < std::numeric_limits<T>::lowest() ? std::numeric_limits<T>::lowest()
+                                                   : (val > std::numeric_limits<T>::max() ? std::numeric_limits<T>::max() : static_cast<T>(val));
+}
+
+/** Counts spread over all magnitudes, limits included. */
+int64_t random_count(std::mt19937_64& rng) {
+    const auto r = static_cast<int64_t>(rng());
+    switch (rng() % 4) {
+        case 0: return r >> (rng() % 64);
+        case 1: return rng() % 2 ? std::numeric_limits<int64_t>::max() - static_cast<int64_t>(rng() % 3)
+                                 : std::numeric_limits<int64_t>::lowest() + static_cast<int64_t>(rng() % 3);
+        default: return r;
+    }
+}
+
+/** Conversions against the exact quotient, truncated towards zero. */
+template <typename ToRep, typename ToPeriod, typename Period>
+void test_cast(std::mt19937_64& rng) {
+    using factor = std::ratio_divide<Period, ToPeriod>;
+    for (int i = 0; i < 100'000; ++i) {
+        const int64_t count = random_count(rng);
+        const saturating::duration<int64_t, Period> d{ count };
+        const auto out = saturating::duration_cast<saturating::duration<ToRep, ToPeriod>>(d);
+        assert(static_cast<ToRep>(out.count()) == saturate<ToRep>(static_cast<wide>(count) * factor::num / factor::den));
+
+        const auto plain = saturating::duration_cast<std::chrono::duration<ToRep, ToPeriod>>(std::chrono::duration<int64_t, Period>{ count });
+        assert(plain.count() == static_cast<ToRep>(out.count()));
+    }
+}
+
+void test_arithmetic(std::mt19937_64& rng) {
+    using namespace saturating;
+    for (int i = 0; i < 1'000'000; ++i) {
+        const int64_t a = random_count(rng), b = random_count(rng);
+        const milliseconds da{ a }, db{ b };
+        assert(static_cast<int64_t>((da + db).count()) == saturate<int64_t>(static_cast<wide>(a) + b));
+        assert(static_cast<int64_t>((da - db).count()) == saturate<int64_t>(static_cast<wide>(a) - b));
+        assert(static_cast<int64_t>((-da).count()) == saturate<int64_t>(-static_cast<wide>(a)));
+        const int64_t k = b >> (rng() % 64);
+        assert(static_cast<int64_t>((da * k).count()) == saturate<int64_t>(static_cast<wide>(a) * k));
+        if (k != 0) {
+            assert(static_cast<int64_t>((da / k).count()) == saturate<int64_t>(static_cast<wide>(a) / k));
+            assert(static_cast<int64_t>(da / db) == saturate<int64_t>(static_cast<wide>(a) / b));
+            assert(static_cast<int64_t>((da % k).count()) == static_cast<int64_t>(static_cast<wide>(a) % k));
+        }
+        assert((da < db) == (a < b));
+
+        // Mixed periods, both converted to the common (finer) unit first
+        const seconds ds{ b };
+        assert(static_cast<int64_t>((da + ds).count()) == saturate<int64_t>(static_cast<wide>(a) + saturate<int64_t>(static_cast<wide>(b) * 1000)));
+        assert((da < ds) == (static_cast<wide>(a) < static_cast<wide>(b) * 1000));
+        assert((ds == da) == (static_cast<wide>(a) == static_cast<wide>(b) * 1000));
+    }
+}
+
+void test_time_points() {
+    using clock = std::chrono::steady_clock;
+    const auto now = clock::now();
+
+    // An infinite timeout is a deadline that never passes, instead of one in the past
+    const auto never = now + saturating::milliseconds::max();
+    assert(never == clock::time_point::max());
+    assert(saturating::deadline(saturating::hours::max()) == clock::time_point::max());
+    assert(saturating::add(now, std::chrono::milliseconds::max()) == clock::time_point::max());
+    // Both overflow only before the epoch, the largest durations convert to `nanoseconds::max()` first
+    const auto before = clock::time_point{} - 2ns;
+    assert(saturating::subtract(before, std::chrono::hours::max()) == clock::time_point::min());
+    assert(before - saturating::seconds::max() == clock::time_point::min());
+
+    const auto soon = saturating::deadline(saturating::milliseconds{ 250 });
+    assert(soon - now >= 250ms && soon - now < 250ms + 1min);
+    assert(saturating::subtract(soon, now) == soon - now);
+    assert(saturating::subtract(clock::time_point::min(), clock::time_point::max()) == saturating::nanoseconds::min());
+    assert(saturating::seconds{ 2 } + now == now + 2s);
+}
+
+int main() {
+    std::mt19937_64 rng(36);
+
+    test_cast<int64_t, std::nano, std::milli>(rng);
+    test_cast<int64_t, std::nano, std::ratio<3600>>(rng);
+    test_cast<int64_t, std::milli, std::nano>(rng);
+    test_cast<int64_t, std::ratio<60>, std::milli>(rng);
+    test_cast<int32_t, std::milli, std::micro>(rng);
+    test_cast<uint32_t, std::milli, std::ratio<1>>(rng);
+    test_cast<int64_t, std::ratio<1, 30>, std::ratio<1, 1000>>(rng);  // Frames from milliseconds
+    test_cast<int64_t, std::ratio<1, 1000>, std::ratio<1, 30>>(rng);
+    test_cast<int16_t, std::ratio<7, 3>, std::ratio<5, 11>>(rng);
+
+    test_arithmetic(rng);
+    test_time_points();
+
+    const std::size_t samples = 10'000'000;
+    std::vector<std::chrono::milliseconds> timeouts(samples);
+    std::vector<std::chrono::steady_clock::time_point> deadlines(samples);
+    for (auto& t : timeouts) t = std::chrono::milliseconds{ static_cast<int64_t>(rng() % 100'000) };
+    const auto now = std::chrono::steady_clock::now();
+
+    auto start = std::chrono::system_clock::now();
+    for (std::size_t i = 0; i < samples; ++i) deadlines[i] = now + timeouts[i];
+    auto end = std::chrono::system_clock::now();
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+    std::cout << "std::chrono deadlines took " << elapsed.count() << " ms" << std::endl;
+    const auto check = deadlines;
+
+    start = std::chrono::system_clock::now();
+    for (std::size_t i = 0; i < samples; ++i) deadlines[i] = saturating::add(now, timeouts[i]);
+    end = std::chrono::system_clock::now();
+    elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+    std::cout << "Saturating deadlines took " << elapsed.count() << " ms" << std::endl;
+    assert(deadlines == check);
+}
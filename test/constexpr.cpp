@@ -0,0 +1,66 @@
+#include <iostream>
+#include <cassert>
+#include <chrono>
+#include <random>
+#include <limits>
+#include "../functions.hpp"
+#include "../types.hpp"
+
+// Everything below must be usable in constant expressions
+static_assert(saturating::round<int>(2.5) == 3);
+static_assert(saturating::round<int>(-2.5) == -3);
+static_assert(saturating::round<int>(2.4999f) == 2);
+static_assert(saturating::round<int>(-0.4) == 0);
+static_assert(saturating::round_saturate<int8_t>(1e30) == 127);
+static_assert(saturating::round_saturate<int8_t>(-1e30f) == -128);
+static_assert(saturating::round_saturate<uint8_t>(-3.0) == 0);
+static_assert(saturating::round_saturate<int32_t>(2147483647.5) == 2147483647);
+static_assert(saturating::round_saturate<int64_t>(9.3e18) == std::numeric_limits<int64_t>::max());
+static_assert(saturating::round_saturate<uint64_t>(1.8e19) == 18000000000000000000ull);
+static_assert(saturating::round_saturate<int>(std::numeric_limits<double>::quiet_NaN()) == 0);
+
+static_assert(saturating::add<int8_t>(100.6, 27) == 127);
+static_assert(saturating::add<int16_t>(-1.5, 1) == -1);
+static_assert(saturating::subtract<uint8_t>(3, 4.5) == 0);
+static_assert(saturating::multiply<int8_t>(0.5, 7) == 4);
+static_assert(saturating::divide<int8_t>(7.0, 2) == 4);
+static_assert(int_sat8_t::from(300.2) == 127);
+static_assert(int_sat8_t::from(-12.5) == -13);
+static_assert(uint_sat8_t::scale_from(0.5f, -1.0f, 1.0f) == 191);
+
+// A compile time lookup table
+template <typename T, std::size_t N>
+struct gain_table {
+    T values[N];
+    constexpr gain_table() : values{} {
+        for (std::size_t i = 0; i < N; ++i) {
+            values[i] = T::multiply(static_cast<double>(i) / (N - 1), 1.5 * T::max_val);
+        }
+    }
+};
+constexpr gain_table<int_sat16_t, 65> gains;
+static_assert(gains.values[0] == 0);
+static_assert(gains.values[32] == 24575);
+static_assert(gains.values[64] == 32767);
+
+int main() {
+    const unsigned samples = 1'000'000;
+    std::mt19937_64 rng(27);
+    std::uniform_real_distribution<double> dis(-1e10, 1e10);
+
+    auto start = std::chrono::system_clock::now();
+    for (unsigned i = 0; i <= samples; ++i) {
+        const double d = dis(rng) / (1 << (i % 32));
+        const float f = static_cast<float>(d);
+        // Constant evaluation and runtime must agree with the standard library
+        assert(saturating::round_half_away(d) == std::round(d));
+        assert(saturating::round_half_away(f) == std::round(f));
+        assert(saturating::round<int64_t>(d) == std::llround(d));
+        assert(saturating::round<int32_t>(f) == std::lround(f));
+        const auto clamped = d > 2147483647.0 ? 2147483647 : (d < -2147483648.0 ? -2147483648 : std::llround(d));
+        assert(saturating::round_saturate<int32_t>(d) == clamped);
+    }
+    auto end = std::chrono::system_clock::now();
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+    std::cout << "Rounding took " << elapsed.count() << " ms" << std::endl;
+}
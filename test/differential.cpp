@@ -0,0 +1,691 @@
+// Differential test of the integral operations against a 128 bit reference.
+//
+// Every operand pair is checked for 8 and 16 bit types (all 2^32 pairs of 16 bit values), wider types
+// and operands of mixed signedness and width (128 bit ones in the GNU dialects) get every pair of
+// boundary values plus random pairs from fixed seeds. Floating point types and operands get random
+// pairs, including halves, infinities and the limits. Work is split over all cores; which cases run does
+// not depend on the number of threads, so a failure reproduces on any machine.
+//
+// Usage: differential [stride], a stride above 1 only checks every stride'th 16 bit right hand operand.
+
+#include <iostream>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <limits>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include "../functions.hpp"
+#include "../types.hpp"
+#include "../parallel.hpp"
+
+/** Reference arithmetic: 64 bits are exact and fast for 8 and 16 bit types, wider types use 128 bits. */
+template <typename S>
+using wide_t = std::conditional_t<sizeof(typename S::value_type) <= sizeof(int16_t), int64_t, __int128_t>;
+
+/** Magnitude saturating every type checked with reference type `W`. */
+template <typename W>
+constexpr W cap = W{1} << (sizeof(W) * 4 + 8);
+
+std::atomic<unsigned long long> failures { 0 };
+std::atomic<unsigned long long> cases { 0 };
+std::mutex report;
+
+template <typename S, typename W>
+W reference(const W val) {
+    return val < S::min_val ? S::min_val : (val > S::max_val ? S::max_val : val);
+}
+
+// Multiply, bounding the magnitude to a value that saturates every tested type
+template <typename W>
+W reference_multiply(const W a, const W b) {
+    const W ma = a < 0 ? -a : a;
+    const W mb = b < 0 ? -b : b;
+    const W magnitude = (mb != 0 && ma > cap<W> / mb) ? cap<W> : ma * mb;
+    return ((a < 0) != (b < 0)) ? -magnitude : magnitude;
+}
+
+// Quotient rounded half away from zero, division by zero saturates towards the sign of `a`
+template <typename W>
+W reference_divide(const W a, const W b) {
+    if (b == 0) return a > 0 ? cap<W> : (a < 0 ? -cap<W> : 0);
+    const W ma = a < 0 ? -a : a;
+    const W mb = b < 0 ? -b : b;
+    const W magnitude = (ma + mb / 2) / mb;
+    return ((a < 0) != (b < 0)) ? -magnitude : magnitude;
+}
+
+// Remainder with the sign of `a`, a zero divisor leaves `a`
+template <typename W>
+W reference_modulo(const W a, const W b) {
+    return b == 0 ? a : a % b;
+}
+
+// Square and multiply, the capped magnitude stays capped
+template <typename W>
+W reference_pow(W base, unsigned exponent) {
+    W result = 1;
+    for (; exponent > 0; exponent >>= 1) {
+        if (exponent & 1) result = reference_multiply(result, base);
+        base = reference_multiply(base, base);
+    }
+    return result;
+}
+
+template <typename W>
+W reference_sqrt(const W val) {
+    if (val <= 0) return 0;
+    W r = static_cast<W>(std::sqrt(static_cast<long double>(val)));
+    while (r * r > val) --r;
+    while ((r + 1) * (r + 1) <= val) ++r;
+    return r;
+}
+
+// round(val / 2^shift), halfway cases up
+template <typename W>
+W reference_shift(const W val, const unsigned shift) {
+    if (shift == 0) return val;
+    const W divisor = W{1} << shift;
+    const W sum = val + divisor / 2;
+    return sum >= 0 ? sum / divisor : -((-sum + divisor - 1) / divisor);
+}
+
+std::string to_string(__int128_t val) {
+    const bool negative = val < 0;
+    std::string s;
+    do {
+        s.insert(s.begin(), static_cast<char>('0' + (negative ? -(val % 10) : val % 10)));
+        val /= 10;
+    } while (val != 0);
+    return negative ? "-" + s : s;
+}
+
+template <typename S, typename W>
+void check(const char* op, const W a, const W b, const W result, const W expected) {
+    if (result != reference<S>(expected)) {
+        if (++failures <= 20) {
+            std::lock_guard<std::mutex> lock(report);
+            std::cout << "Error calculating " << op << "(" << to_string(a) << ", " << to_string(b) << ") ("
+                      << to_string(S::min_val) << "..." << to_string(S::max_val) << "): " << to_string(result)
+                      << ", expected " << to_string(reference<S>(expected)) << std::endl;
+        }
+    }
+}
+
+/** All binary operations on the pair `a`, `b`. */
+template <typename S>
+void test_pair(const typename S::value_type a, const typename S::value_type b) {
+    using T = typename S::value_type;
+    constexpr T MIN = S::min_val;
+    constexpr T MAX = S::max_val;
+    using W = wide_t<S>;
+    const W wa = a;
+    const W wb = b;
+
+    check<S, W>("add", wa, wb, saturating::add<T, MIN, MAX>(a, b), wa + wb);
+    check<S, W>("subtract", wa, wb, saturating::subtract<T, MIN, MAX>(a, b), wa - wb);
+    check<S, W>("multiply", wa, wb, saturating::multiply<T, MIN, MAX>(a, b), reference_multiply(wa, wb));
+    check<S, W>("divide", wa, wb, saturating::divide<T, MIN, MAX>(a, b), reference_divide(wa, wb));
+    check<S, W>("modulo", wa, wb, saturating::modulo<T, MIN, MAX>(a, b), reference_modulo(wa, wb));
+    check<S, W>("abs_diff", wa, wb, saturating::abs_diff<T, MIN, MAX>(a, b), wa > wb ? wa - wb : wb - wa);
+
+    // Operators need a left hand side within the limits
+    if (wa >= MIN && wa <= MAX) {
+        const S x { a };
+        check<S, W>("operator+", wa, wb, x + b, wa + wb);
+        check<S, W>("operator-", wa, wb, x - b, wa - wb);
+        check<S, W>("operator*", wa, wb, x * b, reference_multiply(wa, wb));
+        check<S, W>("operator/", wa, wb, x / b, reference_divide(wa, wb));
+        check<S, W>("operator%", wa, wb, x % b, reference_modulo(wa, wb));
+        S y = x;
+        check<S, W>("operator+=", wa, wb, y += b, wa + wb);
+        y = x;
+        check<S, W>("operator-=", wa, wb, y -= b, wa - wb);
+        y = x;
+        check<S, W>("operator*=", wa, wb, y *= b, reference_multiply(wa, wb));
+        y = x;
+        check<S, W>("operator/=", wa, wb, y /= b, reference_divide(wa, wb));
+        y = x;
+        check<S, W>("operator%=", wa, wb, y %= b, reference_modulo(wa, wb));
+    }
+}
+
+/** Binary operations on operands of other types than `S`, like signed operands into an unsigned or narrower type. */
+template <typename S, typename UA, typename UB>
+void test_mixed_pair(const UA a, const UB b) {
+    using T = typename S::value_type;
+    constexpr T MIN = S::min_val;
+    constexpr T MAX = S::max_val;
+    using W = __int128_t;
+    const W wa = a;
+    const W wb = b;
+
+    check<S, W>("add (mixed)", wa, wb, saturating::add<T, MIN, MAX>(a, b), wa + wb);
+    check<S, W>("subtract (mixed)", wa, wb, saturating::subtract<T, MIN, MAX>(a, b), wa - wb);
+    check<S, W>("multiply (mixed)", wa, wb, saturating::multiply<T, MIN, MAX>(a, b), reference_multiply(wa, wb));
+    check<S, W>("divide (mixed)", wa, wb, saturating::divide<T, MIN, MAX>(a, b), reference_divide(wa, wb));
+    check<S, W>("modulo (mixed)", wa, wb, saturating::modulo<T, MIN, MAX>(a, b), reference_modulo(wa, wb));
+    check<S, W>("abs_diff (mixed)", wa, wb, saturating::abs_diff<T, MIN, MAX>(a, b), wa > wb ? wa - wb : wb - wa);
+}
+
+/** All unary operations (and those with a small parameter) on `a`. */
+template <typename S>
+void test_value(const typename S::value_type a) {
+    using T = typename S::value_type;
+    constexpr T MIN = S::min_val;
+    constexpr T MAX = S::max_val;
+    using W = wide_t<S>;
+    const W wa = a;
+
+    check<S, W>("negate", wa, 0, saturating::negate<T, MIN, MAX>(a), -wa);
+    check<S, W>("abs", wa, 0, saturating::abs<T, MIN, MAX>(a), wa < 0 ? -wa : wa);
+    check<S, W>("square", wa, 0, saturating::square<T, MIN, MAX>(a), reference_multiply(wa, wa));
+    check<S, W>("sqrt", wa, 0, saturating::sqrt<T, MIN, MAX>(a), reference_sqrt(wa));
+    check<S, W>("increment", wa, 0, saturating::increment<T, MIN, MAX>(a), wa + 1);
+    check<S, W>("decrement", wa, 0, saturating::decrement<T, MIN, MAX>(a), wa - 1);
+    for (unsigned shift = 0; shift <= sizeof(T) * 8 + 2; ++shift) {
+        check<S, W>("shift_left", wa, shift, saturating::shift_left<T, MIN, MAX>(a, shift), reference_multiply(wa, W{1} << shift));
+        check<S, W>("rounding_shift_right", wa, shift, saturating::rounding_shift_right<T, MIN, MAX>(a, shift), reference_shift(wa, shift));
+    }
+    for (const unsigned exponent : { 0u, 1u, 2u, 3u, 4u, 5u, 7u, 8u, 13u, 31u, 64u, 1000u }) {
+        check<S, W>("pow", wa, exponent, saturating::pow<T, MIN, MAX>(a, exponent), reference_pow(wa, exponent));
+        check<S, W>("pow (int)", wa, exponent, saturating::pow<T, MIN, MAX>(a, static_cast<int>(exponent)), reference_pow(wa, exponent));
+    }
+    // 1 / a^n truncated towards zero
+    for (const int exponent : { -1, -2, -3, -64, std::numeric_limits<int>::lowest() }) {
+        check<S, W>("pow", wa, exponent, saturating::pow<T, MIN, MAX>(a, exponent), wa == 1 || wa == -1 ? reference_pow(wa, static_cast<unsigned>(exponent & 1)) : 0);
+    }
+
+    if (wa >= MIN && wa <= MAX) {
+        const S x { a };
+        check<S, W>("operator- (unary)", wa, 0, -x, -wa);
+        for (unsigned shift = 0; shift <= sizeof(T) * 8 + 2; shift += 3) {
+            check<S, W>("operator<<", wa, shift, x << shift, reference_multiply(wa, W{1} << shift));
+            S y = x;
+            check<S, W>("operator<<=", wa, shift, y <<= shift, reference_multiply(wa, W{1} << shift));
+        }
+        S y = x;
+        check<S, W>("operator++ (prefix)", wa, 0, ++y, wa + 1);
+        y = x;
+        check<S, W>("operator++ (postfix)", wa, 0, y++, wa);
+        check<S, W>("operator++ (postfix)", wa, 1, y, wa + 1);
+        y = x;
+        check<S, W>("operator-- (prefix)", wa, 0, --y, wa - 1);
+        y = x;
+        check<S, W>("operator-- (postfix)", wa, 0, y--, wa);
+        check<S, W>("operator-- (postfix)", wa, 1, y, wa - 1);
+    }
+}
+
+/** Every value and every pair of values of an 8 or 16 bit type. */
+template <typename S>
+void test_exhaustive(const unsigned stride) {
+    using T = typename S::value_type;
+    constexpr std::size_t count = std::size_t{1} << (sizeof(T) * 8);
+    const auto value = [](std::size_t i) noexcept { return static_cast<T>(static_cast<std::size_t>(std::numeric_limits<T>::lowest()) + i); };
+    const std::size_t step = sizeof(T) == 1 ? 1 : stride;
+
+    saturating::parallel::for_each_chunk(count, saturating::parallel::chunk_count(count, 0, 1), [&](std::size_t, std::size_t begin, std::size_t end) {
+        unsigned long long local = 0;
+        for (std::size_t i = begin; i < end; ++i) {
+            test_value<S>(value(i));
+            // Offset by `i` so strided runs still reach every residue of `b`
+            for (std::size_t j = i % step; j < count; j += step, ++local) {
+                test_pair<S>(value(i), value(j));
+            }
+        }
+        cases += local + (end - begin);
+    });
+}
+
+/** Limits, values around zero, powers of two and square roots, and their neighbours. */
+template <typename S>
+std::vector<typename S::value_type> boundaries() {
+    using T = typename S::value_type;
+    std::vector<__int128_t> candidates {
+        std::numeric_limits<T>::lowest(), std::numeric_limits<T>::max(), S::min_val, S::max_val,
+        __int128_t{S::min_val} / 2, __int128_t{S::max_val} / 2, 0,
+        reference_sqrt(__int128_t{std::numeric_limits<T>::max()}), -reference_sqrt(-__int128_t{std::numeric_limits<T>::lowest()})
+    };
+    for (unsigned bit = 0; bit < sizeof(T) * 8; ++bit) {
+        candidates.push_back(__int128_t{1} << bit);
+        candidates.push_back(-(__int128_t{1} << bit));
+    }
+
+    std::vector<T> values;
+    for (const __int128_t c : candidates) {
+        for (__int128_t v = c - 2; v <= c + 2; ++v) {
+            if (v >= std::numeric_limits<T>::lowest() && v <= std::numeric_limits<T>::max()) values.push_back(static_cast<T>(v));
+        }
+    }
+    return values;
+}
+
+/** Every pair of boundary values, and `units` times 2^16 random pairs. */
+template <typename S>
+void test_sampled(const std::size_t units, const unsigned seed) {
+    using T = typename S::value_type;
+    const auto edges = boundaries<S>();
+    for (const T a : edges) {
+        test_value<S>(a);
+        for (const T b : edges) test_pair<S>(a, b);
+    }
+    cases += edges.size() * (edges.size() + 1);
+
+    saturating::parallel::for_each_chunk(units, saturating::parallel::chunk_count(units, 0, 1), [&](std::size_t, std::size_t begin, std::size_t end) {
+        for (std::size_t unit = begin; unit < end; ++unit) {
+            // Seeded per unit, independent of the thread running it
+            std::mt19937_64 rng(seed * 1'000'003ull + unit);
+            // Random magnitudes, so values near zero and near either limit are as likely as large ones
+            const auto random = [&rng]() {
+                const T v = static_cast<T>(rng() >> (rng() % 64));
+                return (rng() & 1) ? static_cast<T>(~v) : v;
+            };
+            for (unsigned i = 0; i < (1u << 16); ++i) {
+                const T a = random();
+                test_value<S>(a);
+                test_pair<S>(a, random());
+                test_pair<S>(a, edges[rng() % edges.size()]);
+            }
+        }
+        cases += (end - begin) * (3u << 16);
+    });
+}
+
+/** Every pair of boundary values of `UA` and `UB`, and `units` times 2^16 random pairs, into `S`. */
+template <typename S, typename UA, typename UB>
+void test_mixed(const std::size_t units, const unsigned seed) {
+    const auto edges_a = boundaries<saturating::type<UA>>();
+    const auto edges_b = boundaries<saturating::type<UB>>();
+    for (const UA a : edges_a) {
+        for (const UB b : edges_b) test_mixed_pair<S>(a, b);
+    }
+    cases += edges_a.size() * edges_b.size();
+
+    saturating::parallel::for_each_chunk(units, saturating::parallel::chunk_count(units, 0, 1), [&](std::size_t, std::size_t begin, std::size_t end) {
+        for (std::size_t unit = begin; unit < end; ++unit) {
+            std::mt19937_64 rng(seed * 1'000'003ull + unit);
+            const auto random = [&rng](auto v) {
+                v = static_cast<decltype(v)>(rng() >> (rng() % 64));
+                return (rng() & 1) ? static_cast<decltype(v)>(~v) : v;
+            };
+            for (unsigned i = 0; i < (1u << 16); ++i) {
+                test_mixed_pair<S>(random(UA{}), random(UB{}));
+                test_mixed_pair<S>(random(UA{}), edges_b[rng() % edges_b.size()]);
+            }
+        }
+        cases += (end - begin) * (2u << 16);
+    });
+}
+
+/**
+ * Reference of an operation with a floating point type or operand: `val`, computed in the type the operands
+ * promote to, rounded half away from zero for an integral `S` (NaN to zero) and clamped to its limits.
+ */
+template <typename S, typename C>
+typename S::value_type reference_float(const C val) {
+    using T = typename S::value_type;
+    long double v = static_cast<long double>(val);
+    if constexpr (std::is_integral_v<T>) v = v != v ? 0 : std::round(v);
+    const long double lo = S::min_val, hi = S::max_val;
+    return static_cast<T>(v < lo ? lo : (v > hi ? hi : v));
+}
+
+template <typename S, typename UA, typename UB>
+void check_float(const char* op, const UA a, const UB b, const typename S::value_type result, const typename S::value_type expected) {
+    // NaN results (only of floating point `S`) compare equal to each other
+    if (result != expected && (result == result || expected == expected)) {
+        if (++failures <= 20) {
+            std::lock_guard<std::mutex> lock(report);
+            std::cout.precision(std::numeric_limits<long double>::max_digits10);
+            std::cout << "Error calculating " << op << "(" << static_cast<long double>(a) << ", " << static_cast<long double>(b) << ") ("
+                      << static_cast<long double>(S::min_val) << "..." << static_cast<long double>(S::max_val) << "): "
+                      << static_cast<long double>(result) << ", expected " << static_cast<long double>(expected) << std::endl;
+        }
+    }
+}
+
+/** Binary operations with a floating point `S` or operand. */
+template <typename S, typename UA, typename UB>
+void test_float_pair(const UA a, const UB b) {
+    // Integral operands are exact in `long double`, floating point ones compute in the type they promote to
+    using C = std::conditional_t<std::is_floating_point_v<UA> || std::is_floating_point_v<UB>, std::common_type_t<UA, UB>, long double>;
+    const C ca = static_cast<C>(a);
+    const C cb = static_cast<C>(b);
+    const C remainder = cb == 0 ? ca : std::fmod(ca, cb);
+    // Integral operands divide like integral types, also into a floating point `S`: rounded, division by zero saturating towards the sign of `a`
+    const C divided = !std::is_same_v<C, long double> ? ca / cb
+                    : (cb == 0 ? (ca > 0 ? std::numeric_limits<C>::infinity() : (ca < 0 ? -std::numeric_limits<C>::infinity() : 0)) : std::round(ca / cb));
+
+    check_float<S>("add (float)", a, b, S::add(a, b), reference_float<S>(ca + cb));
+    check_float<S>("subtract (float)", a, b, S::subtract(a, b), reference_float<S>(ca - cb));
+    check_float<S>("multiply (float)", a, b, S::multiply(a, b), reference_float<S>(ca * cb));
+    check_float<S>("divide (float)", a, b, S::divide(a, b), reference_float<S>(divided));
+    check_float<S>("modulo (float)", a, b, S::modulo(a, b), reference_float<S>(remainder));
+
+    if constexpr (std::is_same_v<UA, typename S::value_type>) {
+        if (a >= S::min_val && a <= S::max_val) {
+            const S x { a };
+            check_float<S>("operator+ (float)", a, b, x + b, reference_float<S>(ca + cb));
+            check_float<S>("operator- (float)", a, b, x - b, reference_float<S>(ca - cb));
+            check_float<S>("operator* (float)", a, b, x * b, reference_float<S>(ca * cb));
+            check_float<S>("operator/ (float)", a, b, x / b, reference_float<S>(divided));
+            check_float<S>("operator% (float)", a, b, x % b, reference_float<S>(remainder));
+            S y = x;
+            check_float<S>("operator%= (float)", a, b, y %= b, reference_float<S>(remainder));
+        }
+    }
+}
+
+/** Zero, halves around small integers, the limits and infinities of `F`, and random floating point values of any magnitude. */
+template <typename F, typename R>
+F random_float(R& rng) {
+    switch (rng() % 4) {
+        case 0: {
+            constexpr F specials[] { 0, -0.0, 0.5, -0.5, 1, -1, 1.5, -2.5, 0.25,
+                                     std::numeric_limits<F>::max(), std::numeric_limits<F>::lowest(), std::numeric_limits<F>::min(),
+                                     std::numeric_limits<F>::infinity(), -std::numeric_limits<F>::infinity() };
+            return specials[rng() % std::size(specials)];
+        }
+        case 1: return static_cast<F>(static_cast<int>(rng() % 17) - 8) / 2;
+        case 2: return std::ldexp(static_cast<F>(static_cast<int64_t>(rng())) / static_cast<F>(1ull << 63), static_cast<int>(rng() % 160) - 80);
+        default: return static_cast<F>(static_cast<int64_t>(rng() % 2001) - 1000) / 8;
+    }
+}
+
+/** `units` times 2^16 random pairs of `UA` and `UB` into `S`, with a floating point `S`, `UA` or `UB`. */
+template <typename S, typename UA, typename UB>
+void test_float(const std::size_t units, const unsigned seed) {
+    saturating::parallel::for_each_chunk(units, saturating::parallel::chunk_count(units, 0, 1), [&](std::size_t, std::size_t begin, std::size_t end) {
+        for (std::size_t unit = begin; unit < end; ++unit) {
+            std::mt19937_64 rng(seed * 1'000'003ull + unit);
+            const auto random = [&rng](auto v) {
+                if constexpr (std::is_floating_point_v<decltype(v)>) {
+                    return random_float<decltype(v)>(rng);
+                } else {
+                    v = static_cast<decltype(v)>(rng() >> (rng() % 64));
+                    return (rng() & 1) ? static_cast<decltype(v)>(~v) : v;
+                }
+            };
+            for (unsigned i = 0; i < (1u << 16); ++i) test_float_pair<S>(random(UA{}), random(UB{}));
+        }
+        cases += (end - begin) << 16;
+    });
+}
+
+#ifndef __STRICT_ANSI__
+// The 128 bit types are arithmetic types in the GNU dialects only
+
+/**
+ * Reference for the 128 bit types, which no builtin integral widens: sign and magnitude, the magnitude
+ * stopping at 2^128 - 1, beyond every 128 bit limit. Exact for one operation on 128 bit operands.
+ */
+struct capped {
+    bool negative;
+    __uint128_t magnitude;
+
+    template <typename T>
+    static capped of(const T val) {
+        const bool negative = val < T{};
+        return { negative, negative ? __uint128_t{0} - static_cast<__uint128_t>(val) : static_cast<__uint128_t>(val) };
+    }
+
+    static capped make(const bool negative, const __uint128_t magnitude) { return { negative && magnitude != 0, magnitude }; }
+};
+
+bool operator<(const capped& a, const capped& b) {
+    if (a.negative != b.negative) return a.negative;
+    return a.negative ? a.magnitude > b.magnitude : a.magnitude < b.magnitude;
+}
+
+capped operator+(const capped& a, const capped& b) {
+    if (a.negative == b.negative) {
+        __uint128_t sum = 0;
+        return capped::make(a.negative, __builtin_add_overflow(a.magnitude, b.magnitude, &sum) ? ~__uint128_t{0} : sum);
+    }
+    return a.magnitude >= b.magnitude ? capped::make(a.negative, a.magnitude - b.magnitude) : capped::make(b.negative, b.magnitude - a.magnitude);
+}
+
+capped operator-(const capped& a) { return capped::make(!a.negative, a.magnitude); }
+
+capped operator-(const capped& a, const capped& b) { return a + -b; }
+
+capped operator*(const capped& a, const capped& b) {
+    __uint128_t product = 0;
+    return capped::make(a.negative != b.negative, __builtin_mul_overflow(a.magnitude, b.magnitude, &product) ? ~__uint128_t{0} : product);
+}
+
+// Quotient rounded half away from zero, division by zero saturates towards the sign of `a`
+capped operator/(const capped& a, const capped& b) {
+    if (b.magnitude == 0) return capped::make(a.negative, a.magnitude == 0 ? 0 : ~__uint128_t{0});
+    const __uint128_t r = a.magnitude % b.magnitude;
+    return capped::make(a.negative != b.negative, a.magnitude / b.magnitude + (r >= b.magnitude - r ? 1 : 0));
+}
+
+// Remainder with the sign of `a`, a zero divisor leaves `a`
+capped operator%(const capped& a, const capped& b) {
+    return b.magnitude == 0 ? a : capped::make(a.negative, a.magnitude % b.magnitude);
+}
+
+std::string to_string(const capped& val) {
+    __uint128_t m = val.magnitude;
+    std::string s;
+    do {
+        s.insert(s.begin(), static_cast<char>('0' + static_cast<int>(m % 10)));
+        m /= 10;
+    } while (m != 0);
+    return val.negative ? "-" + s : s;
+}
+
+template <typename S>
+capped reference(const capped& val) {
+    const capped lo = capped::of(S::min_val), hi = capped::of(S::max_val);
+    return val < lo ? lo : (hi < val ? hi : val);
+}
+
+template <typename S>
+void check(const char* op, const capped& a, const capped& b, const typename S::value_type result, const capped& expected) {
+    const capped r = capped::of(result), e = reference<S>(expected);
+    if (r.negative != e.negative || r.magnitude != e.magnitude) {
+        if (++failures <= 20) {
+            std::lock_guard<std::mutex> lock(report);
+            std::cout << "Error calculating " << op << "(" << to_string(a) << ", " << to_string(b) << ") ("
+                      << to_string(capped::of(S::min_val)) << "..." << to_string(capped::of(S::max_val)) << "): " << to_string(r)
+                      << ", expected " << to_string(e) << std::endl;
+        }
+    }
+}
+
+// Floor of the square root of the magnitude, zero for negative values
+capped reference_sqrt(const capped& val) {
+    if (val.negative) return capped::make(false, 0);
+    __uint128_t r = static_cast<__uint128_t>(std::sqrt(static_cast<long double>(val.magnitude)));
+    __uint128_t sq = 0;
+    while (__builtin_mul_overflow(r, r, &sq) || sq > val.magnitude) --r;
+    while (!__builtin_mul_overflow(r + 1, r + 1, &sq) && sq <= val.magnitude) ++r;
+    return capped::make(false, r);
+}
+
+/** Unary operations (and those with a small parameter) on a 128 bit `a`. */
+template <typename S>
+void test_wide_value(const typename S::value_type a) {
+    using T = typename S::value_type;
+    constexpr T MIN = S::min_val;
+    constexpr T MAX = S::max_val;
+    const capped ca = capped::of(a);
+    const capped one = capped::make(false, 1);
+
+    check<S>("negate", ca, ca, saturating::negate<T, MIN, MAX>(a), -ca);
+    check<S>("abs", ca, ca, saturating::abs<T, MIN, MAX>(a), capped::make(false, ca.magnitude));
+    check<S>("square", ca, ca, saturating::square<T, MIN, MAX>(a), ca * ca);
+    check<S>("sqrt", ca, ca, saturating::sqrt<T, MIN, MAX>(a), reference_sqrt(ca));
+    check<S>("increment", ca, one, saturating::increment<T, MIN, MAX>(a), ca + one);
+    check<S>("decrement", ca, one, saturating::decrement<T, MIN, MAX>(a), ca - one);
+    for (unsigned shift = 0; shift <= 130; shift += 1 + shift / 8) {
+        const capped factor = capped::make(false, shift < 128 ? __uint128_t{1} << shift : ~__uint128_t{0});
+        check<S>("shift_left", ca, factor, saturating::shift_left<T, MIN, MAX>(a, shift), ca * factor);
+    }
+    for (const int exponent : { 0, 1, 2, 3, 5, 127, 128, 1000, -1, -2, -3 }) {
+        // Beyond 130 factors any magnitude above one is capped already
+        capped expected = one;
+        if (exponent < 0) expected = ca.magnitude != 1 ? capped::make(false, 0) : ((exponent & 1) ? ca : one);
+        for (int i = 0; i < exponent && i < 130; ++i) expected = expected * ca;
+        check<S>("pow", ca, capped::of(exponent), saturating::pow<T, MIN, MAX>(a, exponent), expected);
+    }
+
+    if (!(ca < capped::of(MIN)) && !(capped::of(MAX) < ca)) {
+        const S x { a };
+        check<S>("operator- (unary)", ca, ca, -x, -ca);
+        S y = x;
+        check<S>("operator++ (prefix)", ca, one, ++y, ca + one);
+        y = x;
+        check<S>("operator-- (prefix)", ca, one, --y, ca - one);
+        y = x;
+        check<S>("operator++ (postfix)", ca, one, y++, ca);
+        check<S>("operator++ (postfix)", ca, one, y, ca + one);
+    }
+}
+
+/** Binary operations with 128 bit operands or destination. */
+template <typename S, typename UA, typename UB>
+void test_wide_pair(const UA a, const UB b) {
+    using T = typename S::value_type;
+    constexpr T MIN = S::min_val;
+    constexpr T MAX = S::max_val;
+    const capped ca = capped::of(a);
+    const capped cb = capped::of(b);
+
+    check<S>("add", ca, cb, saturating::add<T, MIN, MAX>(a, b), ca + cb);
+    check<S>("subtract", ca, cb, saturating::subtract<T, MIN, MAX>(a, b), ca - cb);
+    check<S>("multiply", ca, cb, saturating::multiply<T, MIN, MAX>(a, b), ca * cb);
+    check<S>("divide", ca, cb, saturating::divide<T, MIN, MAX>(a, b), ca / cb);
+    check<S>("modulo", ca, cb, saturating::modulo<T, MIN, MAX>(a, b), ca % cb);
+    check<S>("abs_diff", ca, cb, saturating::abs_diff<T, MIN, MAX>(a, b), capped::make(false, (ca - cb).magnitude));
+
+    if constexpr (std::is_same_v<UA, T>) {
+        if (!(ca < capped::of(MIN)) && !(capped::of(MAX) < ca)) {
+            const S x { a };
+            check<S>("operator+", ca, cb, x + b, ca + cb);
+            check<S>("operator-", ca, cb, x - b, ca - cb);
+            check<S>("operator*", ca, cb, x * b, ca * cb);
+            check<S>("operator/", ca, cb, x / b, ca / cb);
+            check<S>("operator%", ca, cb, x % b, ca % cb);
+            S y = x;
+            check<S>("operator+=", ca, cb, y += b, ca + cb);
+            y = x;
+            check<S>("operator-=", ca, cb, y -= b, ca - cb);
+            y = x;
+            check<S>("operator%=", ca, cb, y %= b, ca % cb);
+        }
+    }
+}
+
+/** Limits, values around zero and powers of two of a 128 bit (or narrower) `T`, and their neighbours. */
+template <typename T>
+std::vector<T> wide_boundaries() {
+    std::vector<T> candidates { std::numeric_limits<T>::lowest(), std::numeric_limits<T>::max(),
+                                static_cast<T>(std::numeric_limits<T>::lowest() / 2), static_cast<T>(std::numeric_limits<T>::max() / 2), 0 };
+    for (unsigned bit = 0; bit + 1 < sizeof(T) * 8; ++bit) {
+        candidates.push_back(static_cast<T>(T{1} << bit));
+        if constexpr (std::is_signed_v<T>) candidates.push_back(static_cast<T>(-(T{1} << bit)));
+    }
+    std::vector<T> values;
+    for (const T c : candidates) {
+        for (int d = -2; d <= 2; ++d) {
+            T v = 0;
+            if (!__builtin_add_overflow(c, d, &v)) values.push_back(v);
+        }
+    }
+    return values;
+}
+
+/** Every pair of boundary values of `UA` and `UB`, and `units` times 2^16 random pairs, into the 128 bit or narrower `S`. */
+template <typename S, typename UA, typename UB>
+void test_wide(const std::size_t units, const unsigned seed) {
+    const auto edges_a = wide_boundaries<UA>();
+    const auto edges_b = wide_boundaries<UB>();
+    for (const UA a : edges_a) {
+        if constexpr (std::is_same_v<UA, typename S::value_type>) test_wide_value<S>(a);
+        for (const UB b : edges_b) test_wide_pair<S>(a, b);
+    }
+    cases += edges_a.size() * (edges_b.size() + 1);
+
+    saturating::parallel::for_each_chunk(units, saturating::parallel::chunk_count(units, 0, 1), [&](std::size_t, std::size_t begin, std::size_t end) {
+        for (std::size_t unit = begin; unit < end; ++unit) {
+            std::mt19937_64 rng(seed * 1'000'003ull + unit);
+            const auto random = [&rng](auto v) {
+                const __uint128_t bits = (static_cast<__uint128_t>(rng()) << 64) | rng();
+                v = static_cast<decltype(v)>(bits >> (rng() % 128));
+                return (rng() & 1) ? static_cast<decltype(v)>(~v) : v;
+            };
+            for (unsigned i = 0; i < (1u << 16); ++i) {
+                if constexpr (std::is_same_v<UA, typename S::value_type>) test_wide_value<S>(random(UA{}));
+                test_wide_pair<S>(random(UA{}), random(UB{}));
+                test_wide_pair<S>(random(UA{}), edges_b[rng() % edges_b.size()]);
+            }
+        }
+        cases += (end - begin) * (3u << 16);
+    });
+}
+#endif
+
+int main(int argc, char** argv) {
+    const unsigned stride = argc > 1 ? static_cast<unsigned>(std::stoul(argv[1])) : 1;
+
+    auto start = std::chrono::system_clock::now();
+    test_exhaustive<int_sat8_t>(stride);
+    test_exhaustive<uint_sat8_t>(stride);
+    test_exhaustive<saturating::type<int8_t, -100, 50>>(stride);
+    test_exhaustive<saturating::type<uint8_t, 16, 200>>(stride);
+    test_exhaustive<int_sat16_t>(stride);
+    test_exhaustive<uint_sat16_t>(stride);
+
+    test_sampled<saturating::type<int16_t, -1000, 3000>>(8, 1);
+    test_sampled<saturating::type<uint16_t, 1000, 2000>>(8, 2);
+    test_sampled<int_sat32_t>(16, 3);
+    test_sampled<uint_sat32_t>(16, 4);
+    test_sampled<saturating::type<int32_t, -100000, 7>>(8, 5);
+    test_sampled<int_sat64_t>(16, 6);
+    test_sampled<uint_sat64_t>(16, 7);
+    test_sampled<saturating::type<int64_t, std::numeric_limits<int64_t>::lowest() / 3, 1ll << 40>>(8, 8);
+
+    test_mixed<uint_sat32_t, int32_t, int32_t>(4, 9);
+    test_mixed<uint_sat64_t, int32_t, int32_t>(4, 10);
+    test_mixed<uint_sat64_t, int64_t, uint64_t>(4, 11);
+    test_mixed<int_sat64_t, uint64_t, int64_t>(4, 12);
+    test_mixed<int_sat32_t, uint32_t, int32_t>(4, 13);
+    test_mixed<int_sat32_t, uint64_t, uint64_t>(4, 14);
+    test_mixed<int_sat8_t, int32_t, uint16_t>(4, 15);
+    test_mixed<uint_sat16_t, int64_t, int8_t>(4, 16);
+    test_mixed<saturating::type<uint16_t, 1000, 2000>, int32_t, uint32_t>(4, 17);
+
+    test_float<float_sat_t, float, float>(4, 26);
+    test_float<double_sat_t, double, double>(4, 27);
+    test_float<double_sat_t, float, int32_t>(4, 28);
+    test_float<float_sat_t, int64_t, uint32_t>(4, 29);
+    test_float<int_sat32_t, double, double>(4, 30);
+    test_float<uint_sat8_t, float, int16_t>(4, 31);
+    test_float<int_sat64_t, int64_t, double>(4, 32);
+    test_float<saturating::type<int16_t, -1000, 3000>, int32_t, float>(4, 33);
+
+#ifndef __STRICT_ANSI__
+    test_wide<int_sat128_t, __int128_t, __int128_t>(4, 18);
+    test_wide<uint_sat128_t, __uint128_t, __uint128_t>(4, 19);
+    test_wide<int_sat128_t, __uint128_t, __int128_t>(4, 20);
+    test_wide<uint_sat128_t, __int128_t, __int128_t>(4, 21);
+    test_wide<uint_sat128_t, __uint128_t, int64_t>(4, 22);
+    test_wide<int_sat128_t, int64_t, __uint128_t>(4, 23);
+    test_wide<int_sat64_t, __uint128_t, __int128_t>(4, 24);
+    test_wide<saturating::type<__int128_t, -(__int128_t{1} << 100), __int128_t{1} << 90>, __int128_t, __int128_t>(4, 25);
+#endif
+    auto end = std::chrono::system_clock::now();
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+
+    std::cout << "Differential test of " << cases << " cases on " << saturating::parallel::default_threads()
+              << " threads took " << elapsed.count() << " ms" << std::endl;
+    if (failures > 0) std::cout << failures << " failures" << std::endl;
+    assert(failures == 0);
+}
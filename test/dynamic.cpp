@@ -0,0 +1,174 @@
+#include <iostream>
+#include <cassert>
+#include <chrono>
+#include <random>
+#include <limits>
+#include <vector>
+#include "../types.hpp"
+#include "../batch.hpp"
+#include "../dynamic.hpp"
+
+using saturating::bounds;
+using saturating::dynamic_type;
+
+static_assert(dynamic_type<int8_t>{ 100, bounds<int8_t>{ -10, 110 } } + 50 == 110);
+static_assert(dynamic_type<uint8_t>{ 3, bounds<uint8_t>{ 2, 9 } } - 5 == 2);
+static_assert(-dynamic_type<int16_t>{ 7, bounds<int16_t>{ -3, 3 } } == -3);
+static_assert(dynamic_type<int32_t>{ int_sat32_t{ 4 } } * 1'000'000'000 == std::numeric_limits<int32_t>::max());
+static_assert(dynamic_type<float>{ 0.5f, bounds<float>{ -0.25f, 0.75f } } + 1.0f == 0.75f);
+static_assert(dynamic_type<uint8_t>{ bounds<uint8_t>{ 16, 235 } } == 16);
+static_assert(dynamic_type<uint32_t>{ 5u, bounds<uint32_t>{} } % -2 == 1);
+static_assert(dynamic_type<int32_t>{ -7, bounds<int32_t>{ -10, 10 } } % 4u == -3);
+static_assert(std::is_convertible_v<int_sat32_t, dynamic_type<int32_t>>);
+static_assert(!std::is_convertible_v<int_sat16_t, dynamic_type<int32_t>>);
+static_assert(!std::is_convertible_v<uint_sat32_t, dynamic_type<int32_t>>);
+
+template <typename S>
+using T_of = typename S::value_type;
+
+/** Every value of an 8 bit `T`, quarters around the limits of a floating point one. */
+template <typename T>
+std::vector<T> test_values() {
+    std::vector<T> values;
+    if constexpr (std::is_floating_point_v<T>) {
+        for (int i = -12; i <= 12; ++i) values.push_back(static_cast<T>(i) / 4);
+    } else {
+        for (int a = std::numeric_limits<T>::lowest(); a <= std::numeric_limits<T>::max(); ++a) values.push_back(static_cast<T>(a));
+    }
+    return values;
+}
+
+/** Every operation on every value pair, against the compile time type with the same limits. */
+template <typename S>
+void test_against_type() {
+    using T = T_of<S>;
+    const auto limits = bounds<T>::template of<S>();
+    const auto values = test_values<T>();
+    for (const T a : values) {
+        const S sa = S::from(a);
+        const dynamic_type<T> da { a, limits };
+        assert(static_cast<T>(da) == static_cast<T>(sa));
+
+        for (const T tb : values) {
+            assert(static_cast<T>(da + tb) == static_cast<T>(S::add(static_cast<T>(sa), tb)));
+            assert(static_cast<T>(da - tb) == static_cast<T>(S::subtract(static_cast<T>(sa), tb)));
+            assert(static_cast<T>(da * tb) == static_cast<T>(S::multiply(static_cast<T>(sa), tb)));
+            const T quotient = da / tb, expected = S::divide(static_cast<T>(sa), tb);
+            assert(quotient == expected || (quotient != quotient && expected != expected));  // 0 / 0 is NaN on both
+            assert(static_cast<T>(tb + da) == static_cast<T>(S::add(tb, static_cast<T>(sa))));
+            assert(static_cast<T>(tb - da) == static_cast<T>(S::subtract(tb, static_cast<T>(sa))));
+            assert(static_cast<T>(tb * da) == static_cast<T>(S::multiply(tb, static_cast<T>(sa))));
+        }
+        assert(static_cast<T>(-da) == static_cast<T>(-sa));
+        if constexpr (std::is_integral_v<T>) {
+            for (unsigned shift = 0; shift < 12; ++shift) assert(static_cast<T>(da << shift) == static_cast<T>(sa << shift));
+        }
+
+        dynamic_type<T> inc = da, dec = da;
+        S sinc = sa, sdec = sa;
+        ++inc; --dec; ++sinc; --sdec;
+        assert(static_cast<T>(inc) == static_cast<T>(sinc) && static_cast<T>(dec) == static_cast<T>(sdec));
+
+        // Interop: static to dynamic and back
+        const dynamic_type<T> converted = sa;
+        assert(converted.limits().lo == S::min_val && converted.limits().hi == S::max_val);
+        assert(converted.template to<S>() == sa);
+    }
+}
+
+template <typename T>
+T random_value(std::mt19937_64& rng) {
+    if constexpr (std::is_floating_point_v<T>) {
+        return std::uniform_real_distribution<T>(-4, 4)(rng);
+    } else {
+        const T r = static_cast<T>(rng());
+        return rng() % 2 ? r : static_cast<T>(r >> (rng() % (sizeof(T) * 8)));
+    }
+}
+
+/** Batch kernels against the scalar `dynamic_type` operations. */
+template <typename T>
+void test_batch(std::mt19937_64& rng, std::size_t n) {
+    T lo = random_value<T>(rng), hi = random_value<T>(rng);
+    if (hi < lo) std::swap(lo, hi);
+    const bounds<T> limits { lo, hi };
+    const bounds<T> full {};
+
+    std::vector<T> a(n), b(n), out(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        a[i] = random_value<T>(rng);
+        b[i] = random_value<T>(rng);
+    }
+    const T c = random_value<T>(rng);
+    // The inputs need not lie within the limits, results are the exact results clamped
+    const auto expect = [&](const T x) { return limits.clamp(x); };
+
+    saturating::batch::add(a.data(), b.data(), out.data(), n, limits);
+    for (std::size_t i = 0; i < n; ++i) assert(out[i] == expect(dynamic_type<T>{ a[i], full } + b[i]));
+    saturating::batch::subtract(a.data(), b.data(), out.data(), n, limits);
+    for (std::size_t i = 0; i < n; ++i) assert(out[i] == expect(dynamic_type<T>{ a[i], full } - b[i]));
+    saturating::batch::multiply(a.data(), b.data(), out.data(), n, limits);
+    for (std::size_t i = 0; i < n; ++i) assert(out[i] == expect(dynamic_type<T>{ a[i], full } * b[i]));
+    saturating::batch::add(a.data(), c, out.data(), n, limits);
+    for (std::size_t i = 0; i < n; ++i) assert(out[i] == expect(dynamic_type<T>{ a[i], full } + c));
+    saturating::batch::multiply(a.data(), c, out.data(), n, limits);
+    for (std::size_t i = 0; i < n; ++i) assert(out[i] == expect(dynamic_type<T>{ a[i], full } * c));
+    saturating::batch::clip(a.data(), out.data(), n, limits);
+    for (std::size_t i = 0; i < n; ++i) assert(out[i] == expect(a[i]));
+}
+
+template <typename T>
+void test_batch_sizes(std::mt19937_64& rng) {
+    for (std::size_t n = 0; n < 70; ++n) test_batch<T>(rng, n);
+    test_batch<T>(rng, 10'001);
+}
+
+int main() {
+    test_against_type<int_sat8_t>();
+    test_against_type<uint_sat8_t>();
+    test_against_type<saturating::type<int8_t, -100, 50>>();
+    test_against_type<saturating::type<uint8_t, 16, 200>>();
+    test_against_type<float_sat_t>();
+    test_against_type<double_sat_t>();
+
+    // The lowest value modulo -1 traps in plain arithmetic (volatile, so the compiler cannot fold it away)
+    const volatile int32_t minus_one = -1;
+    dynamic_type<int32_t> lowest { std::numeric_limits<int32_t>::lowest(), bounds<int32_t>{} };
+    assert((lowest %= minus_one) == 0);
+    assert((dynamic_type<int64_t>{ std::numeric_limits<int64_t>::lowest(), bounds<int64_t>{} } % int64_t{ minus_one }) == 0);
+    assert((dynamic_type<double>{ 7.5, bounds<double>{ -10, 10 } } % 2) == 1.5);
+
+    std::mt19937_64 rng(37);
+    test_batch_sizes<int8_t>(rng);
+    test_batch_sizes<uint8_t>(rng);
+    test_batch_sizes<int16_t>(rng);
+    test_batch_sizes<uint16_t>(rng);
+    test_batch_sizes<int32_t>(rng);
+    test_batch_sizes<uint32_t>(rng);
+    test_batch_sizes<int64_t>(rng);
+    test_batch_sizes<uint64_t>(rng);
+    test_batch_sizes<float>(rng);
+    test_batch_sizes<double>(rng);
+
+    using S = saturating::type<int16_t, -20000, 20000>;
+    const std::size_t samples = 1 << 24;
+    std::vector<S> in(samples), out(samples);
+    std::vector<int16_t> plain_out(samples);
+    for (auto& v : in) v = S::from(static_cast<int16_t>(rng()));
+    const int16_t* plain_in = saturating::batch::detail::values(in.data());
+
+    auto start = std::chrono::system_clock::now();
+    saturating::batch::multiply(in.data(), int16_t{ 3 }, out.data(), samples);
+    auto end = std::chrono::system_clock::now();
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+    std::cout << "Compile time limits took " << elapsed.count() << " ms" << std::endl;
+
+    const bounds<int16_t> limits { -20000, 20000 };  // As if read from configuration
+    start = std::chrono::system_clock::now();
+    saturating::batch::multiply(plain_in, int16_t{ 3 }, plain_out.data(), samples, limits);
+    end = std::chrono::system_clock::now();
+    elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+    std::cout << "Runtime limits took " << elapsed.count() << " ms" << std::endl;
+
+    for (std::size_t i = 0; i < samples; ++i) assert(static_cast<int16_t>(out[i]) == plain_out[i]);
+}
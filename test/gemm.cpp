@@ -0,0 +1,67 @@
+#include <iostream>
+#include <cassert>
+#include <chrono>
+#include <random>
+#include <limits>
+#include <vector>
+#include "../types.hpp"
+#include "../gemm.hpp"
+
+template <typename SC, typename SA, typename SB>
+void test_gemm(std::mt19937_64& rng, std::size_t m, std::size_t n, std::size_t k, unsigned shift, unsigned threads) {
+    // Leading dimensions with some padding, to catch stride mix-ups
+    const std::size_t lda = k + 3, ldb = n + 1, ldc = n + 2;
+    std::vector<SA> a(m * lda);
+    std::vector<SB> b(k * ldb);
+    std::vector<SC> c(m * ldc, SC{ 42 });
+    for (auto& v : a) v = SA{ static_cast<typename SA::value_type>(rng()) };
+    for (auto& v : b) v = SB{ static_cast<typename SB::value_type>(rng()) };
+    // Some all-extreme rows and columns to hit saturation
+    for (std::size_t j = 0; j < k && m > 0; ++j) a[j] = SA{ SA::max_val };
+    for (std::size_t i = 0; i < k && n > 0; ++i) b[i * ldb] = SB{ SB::min_val };
+    // min * min pairs: the one sum of two 16 bit products that overflows 32 bits
+    for (std::size_t j = 0; j < k && m > 1; ++j) a[lda + j] = SA{ SA::min_val };
+
+    saturating::gemm(m, n, k, a.data(), lda, b.data(), ldb, c.data(), ldc, shift, threads);
+
+    for (std::size_t i = 0; i < m; ++i) {
+        for (std::size_t j = 0; j < n; ++j) {
+            int64_t sum = 0;
+            for (std::size_t p = 0; p < k; ++p) {
+                sum += static_cast<int64_t>(a[i * lda + p]) * static_cast<int64_t>(b[p * ldb + j]);
+            }
+            const auto expected = SC::rounding_shift_right(sum, shift);
+            if (c[i * ldc + j] != expected) {
+                std::cout << "Error in " << m << "x" << n << "x" << k << " product at (" << i << ", " << j << "): "
+                          << +c[i * ldc + j] << ", expected " << +expected << std::endl;
+                assert(c[i * ldc + j] == expected);
+            }
+        }
+        // Padding must stay untouched
+        for (std::size_t j = n; j < ldc; ++j) assert(c[i * ldc + j] == 42);
+    }
+}
+
+int main() {
+    std::mt19937_64 rng(31);
+    const std::size_t sizes[] = { 0, 1, 3, 4, 17, 64, 65, 130, 257, 300 };
+
+    auto start = std::chrono::system_clock::now();
+    for (unsigned i = 0; i < 120; ++i) {
+        const std::size_t m = sizes[rng() % std::size(sizes)];
+        const std::size_t n = sizes[rng() % std::size(sizes)];
+        const std::size_t k = sizes[rng() % std::size(sizes)];
+        const unsigned threads = 1 + i % 4;
+        test_gemm<int_sat8_t, int_sat8_t, int_sat8_t>(rng, m, n, k, 7, threads);
+        test_gemm<int_sat32_t, int_sat8_t, int_sat8_t>(rng, m, n, k, 0, threads);
+        test_gemm<uint_sat8_t, uint_sat8_t, int_sat8_t>(rng, m, n, k, 10, threads);
+        test_gemm<int_sat16_t, uint_sat8_t, uint_sat8_t>(rng, m, n, k, 4, threads);
+        test_gemm<int_sat16_t, int_sat16_t, int_sat16_t>(rng, m, n, k, 15, threads);
+        test_gemm<int_sat32_t, uint_sat16_t, int_sat8_t>(rng, m, n, k, 3, threads);
+    }
+    // Deep enough to need the 64 bit accumulator for 8 bit inputs
+    test_gemm<int_sat32_t, uint_sat8_t, uint_sat8_t>(rng, 5, 9, 40000, 0, 2);
+    auto end = std::chrono::system_clock::now();
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+    std::cout << "Matrix multiplication took " << elapsed.count() << " ms" << std::endl;
+}
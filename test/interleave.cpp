@@ -0,0 +1,183 @@
+#include <iostream>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <limits>
+#include <vector>
+#include "../types.hpp"
+#include "../interleave.hpp"
+
+template <typename SIn, typename SOut>
+using param_t = typename saturating::detail::interleave::convert_t<SIn, SOut>::param_t;
+
+/** Scalar reference of the conversions, see `interleave.hpp`. */
+template <typename SIn, typename SOut>
+typename SOut::value_type reference(const typename SIn::value_type x, const param_t<SIn, SOut> param) {
+    using TI = typename SIn::value_type;
+    using TO = typename SOut::value_type;
+    using F = typename saturating::detail::interleave::convert_t<SIn, SOut>::F;
+    const auto saturate = [](const long double v) {
+        return static_cast<TO>(v < SOut::min_val ? SOut::min_val : (v > SOut::max_val ? SOut::max_val : v));
+    };
+
+    if constexpr (std::is_integral_v<TI> && std::is_integral_v<TO>) {
+        const auto v = static_cast<long double>(x);
+        return saturate(param == 0 ? v : std::floor(v / std::ldexp(1.0L, static_cast<int>(param)) + 0.5L));
+    } else if constexpr (std::is_integral_v<TO>) {
+        const TI v = x * param;
+        return v != v ? saturate(0) : saturate(std::nearbyint(static_cast<long double>(v)));
+    } else {
+        const F v = static_cast<F>(x) * param;
+        return static_cast<TO>(v < static_cast<F>(SOut::min_val) ? static_cast<F>(SOut::min_val)
+                                                                 : (v > static_cast<F>(SOut::max_val) ? static_cast<F>(SOut::max_val) : v));
+    }
+}
+
+template <typename T>
+T random_value(std::mt19937_64& rng) {
+    if constexpr (std::is_floating_point_v<T>) {
+        switch (rng() % 16) {
+            case 0: return std::numeric_limits<T>::quiet_NaN();
+            case 1: return rng() % 2 ? std::numeric_limits<T>::infinity() : -std::numeric_limits<T>::infinity();
+            case 2: return std::ldexp(std::uniform_real_distribution<T>(-1, 1)(rng), static_cast<int>(rng() % 70));
+            case 3: return static_cast<T>(static_cast<int>(rng() % 9) - 4) * T{ 0.5 } / 32768;  // Halfway cases
+            default: return std::uniform_real_distribution<T>(-1.5, 1.5)(rng);
+        }
+    } else {
+        const T r = static_cast<T>(rng());
+        return rng() % 2 ? r : static_cast<T>(r >> (rng() % (sizeof(T) * 8)));
+    }
+}
+
+template <typename T>
+bool same(const T a, const T b) {
+    if constexpr (std::is_floating_point_v<T>) return a == b || (a != a && b != b);
+    else return a == b;
+}
+
+template <typename SIn, typename SOut>
+void test_conversion(std::mt19937_64& rng, const param_t<SIn, SOut> param) {
+    using TI = typename SIn::value_type;
+    using TO = typename SOut::value_type;
+    for (std::size_t channels = 1; channels <= 6; ++channels) {
+        for (std::size_t frames : { 0, 1, 7, 8, 15, 16, 17, 33, 64, 100, 1001 }) {
+            std::vector<SIn> interleaved(frames * channels);
+            for (auto& v : interleaved) v = SIn{ random_value<TI>(rng) };
+            std::vector<std::vector<SOut>> planar(channels, std::vector<SOut>(frames));
+            std::vector<SOut*> out(channels);
+            for (std::size_t c = 0; c < channels; ++c) out[c] = planar[c].data();
+
+            saturating::deinterleave(interleaved.data(), channels, out.data(), frames, param);
+            for (std::size_t i = 0; i < frames; ++i) {
+                for (std::size_t c = 0; c < channels; ++c) {
+                    const auto expected = reference<SIn, SOut>(static_cast<TI>(interleaved[i * channels + c]), param);
+                    assert(same(static_cast<TO>(planar[c][i]), expected));
+                }
+            }
+
+            // Back: the planar inputs are those of the first conversion
+            std::vector<std::vector<SIn>> sources(channels, std::vector<SIn>(frames));
+            std::vector<const SIn*> in(channels);
+            for (std::size_t c = 0; c < channels; ++c) {
+                for (std::size_t i = 0; i < frames; ++i) sources[c][i] = interleaved[i * channels + c];
+                in[c] = sources[c].data();
+            }
+            std::vector<SOut> merged(frames * channels);
+            saturating::interleave(in.data(), channels, merged.data(), frames, param);
+            for (std::size_t i = 0; i < frames * channels; ++i) assert(same(static_cast<TO>(merged[i]), static_cast<TO>(planar[i % channels][i / channels])));
+        }
+    }
+}
+
+template <typename SIn, typename SOut>
+void test_conversion(std::mt19937_64& rng) {
+    test_conversion<SIn, SOut>(rng, saturating::detail::interleave::convert_t<SIn, SOut>::default_param());
+}
+
+int main() {
+    std::mt19937_64 rng(39);
+
+    test_conversion<int_sat16_t, float_sat_t>(rng);
+    test_conversion<int_sat16_t, float_sat_t>(rng, 1.0f / 1000);
+    test_conversion<float_sat_t, int_sat16_t>(rng);
+    test_conversion<uint_sat8_t, float_sat_t>(rng);
+    test_conversion<float_sat_t, uint_sat8_t>(rng, 255.0f);
+    test_conversion<double_sat_t, int_sat32_t>(rng);
+    test_conversion<float_sat_t, int_sat32_t>(rng);
+    test_conversion<float_sat_t, uint_sat32_t>(rng, 4294967296.0f);
+    test_conversion<double_sat_t, int_sat64_t>(rng);
+    test_conversion<float_sat_t, saturating::type<int32_t, -2147483647, 2147483000>>(rng);
+    test_conversion<int_sat32_t, double_sat_t>(rng);
+    test_conversion<double_sat_t, float_sat_t>(rng, 0.5);
+    test_conversion<float_sat_t, double_sat_t>(rng);
+    test_conversion<int_sat32_t, int_sat16_t>(rng);
+    test_conversion<int_sat32_t, int_sat16_t>(rng, 8);
+    test_conversion<int_sat16_t, int_sat32_t>(rng, 3);
+    test_conversion<uint_sat16_t, int_sat8_t>(rng, 4);
+    test_conversion<int_sat8_t, uint_sat16_t>(rng);
+    test_conversion<int_sat8_t, saturating::type<int16_t, -100, 100>>(rng);
+    test_conversion<int_sat8_t, saturating::type<uint8_t, 200, 255>>(rng);
+    test_conversion<uint_sat8_t, uint_sat8_t>(rng, 9);
+    test_conversion<int_sat64_t, int_sat32_t>(rng, 40);
+    test_conversion<uint_sat64_t, double_sat_t>(rng);
+    test_conversion<int_sat64_t, double_sat_t>(rng);
+    test_conversion<int_sat64_t, float_sat_t>(rng);
+    test_conversion<double_sat_t, uint_sat64_t>(rng);
+
+    // Stereo: interleaved 16 bit samples to planar floating point, and planar 32 bit mixes back to 16 bit
+    const std::size_t frames = 1 << 23;
+    std::vector<int_sat16_t> samples(frames * 2);
+    for (auto& s : samples) s = int_sat16_t{ static_cast<int16_t>(rng()) };
+    std::vector<int_sat16_t> tmp_left(frames), tmp_right(frames);
+    std::vector<float_sat_t> left(frames), right(frames), check_left(frames), check_right(frames);
+
+    auto start = std::chrono::system_clock::now();
+    for (std::size_t i = 0; i < frames; ++i) {
+        tmp_left[i] = samples[2 * i];
+        tmp_right[i] = samples[2 * i + 1];
+    }
+    for (std::size_t i = 0; i < frames; ++i) {
+        check_left[i] = float_sat_t{ static_cast<float>(static_cast<int16_t>(tmp_left[i])) / 32768 };
+        check_right[i] = float_sat_t{ static_cast<float>(static_cast<int16_t>(tmp_right[i])) / 32768 };
+    }
+    auto end = std::chrono::system_clock::now();
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+    std::cout << "Deinterleave then convert took " << elapsed.count() << " ms" << std::endl;
+
+    float_sat_t* planar[] = { left.data(), right.data() };
+    start = std::chrono::system_clock::now();
+    saturating::deinterleave(samples.data(), 2, planar, frames);
+    end = std::chrono::system_clock::now();
+    elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+    std::cout << "Fused deinterleave took " << elapsed.count() << " ms" << std::endl;
+    assert(left == check_left && right == check_right);
+
+    std::vector<int_sat32_t> mix_left(frames), mix_right(frames);
+    for (std::size_t i = 0; i < frames; ++i) {
+        mix_left[i] = int_sat32_t{ static_cast<int32_t>(rng()) >> (rng() % 20) };
+        mix_right[i] = int_sat32_t{ static_cast<int32_t>(rng()) >> (rng() % 20) };
+    }
+    std::vector<int_sat16_t> narrow_left(frames), narrow_right(frames), out(frames * 2), check(frames * 2);
+
+    start = std::chrono::system_clock::now();
+    for (std::size_t i = 0; i < frames; ++i) {
+        narrow_left[i] = int_sat16_t::rounding_shift_right(mix_left[i], 0);
+        narrow_right[i] = int_sat16_t::rounding_shift_right(mix_right[i], 0);
+    }
+    for (std::size_t i = 0; i < frames; ++i) {
+        check[2 * i] = narrow_left[i];
+        check[2 * i + 1] = narrow_right[i];
+    }
+    end = std::chrono::system_clock::now();
+    elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+    std::cout << "Convert then interleave took " << elapsed.count() << " ms" << std::endl;
+
+    const int_sat32_t* mixes[] = { mix_left.data(), mix_right.data() };
+    start = std::chrono::system_clock::now();
+    saturating::interleave(mixes, 2, out.data(), frames);
+    end = std::chrono::system_clock::now();
+    elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+    std::cout << "Fused interleave took " << elapsed.count() << " ms" << std::endl;
+    assert(out == check);
+}
@@ -0,0 +1,158 @@
+#include <iostream>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <limits>
+#include <vector>
+#include "../functions.hpp"
+#include "../types.hpp"
+#include "../batch.hpp"
+
+using wide = __int128_t;
+
+template <typename T>
+typename T::value_type reference(const wide val) {
+    return static_cast<typename T::value_type>(val < T::min_val ? T::min_val : (val > T::max_val ? T::max_val : val));
+}
+
+// Multiply, bounding the magnitude to a value that saturates every tested type
+wide reference_multiply(const wide a, const wide b) {
+    const wide cap = wide{1} << 80;
+    const wide ma = a < 0 ? -a : a;
+    const wide mb = b < 0 ? -b : b;
+    const wide magnitude = (mb != 0 && ma > cap / mb) ? cap : ma * mb;
+    return ((a < 0) != (b < 0)) ? -magnitude : magnitude;
+}
+
+wide reference_pow(const wide base, const unsigned exponent) {
+    wide result = 1;
+    for (unsigned i = 0; i < exponent; ++i) {
+        result = reference_multiply(result, base);
+    }
+    return result;
+}
+
+wide reference_sqrt(const wide val) {
+    if (val <= 0) return 0;
+    wide r = static_cast<wide>(std::sqrt(static_cast<long double>(val)));
+    while (r * r > val) --r;
+    while ((r + 1) * (r + 1) <= val) ++r;
+    return r;
+}
+
+template <typename T>
+void check(const char* op, const wide a, const wide b, const typename T::value_type result, const wide expected) {
+    if (result != reference<T>(expected)) {
+        std::cout << "Error calculating " << op << "(" << static_cast<long long>(a) << ", " << static_cast<long long>(b)
+                  << ") (" << +T::min_val << "..." << +T::max_val << "): " << +result
+                  << ", expected " << +reference<T>(expected) << std::endl;
+        assert(result == reference<T>(expected));
+    }
+}
+
+template <typename T>
+void test_math_impl(const typename T::value_type& a, const typename T::value_type& b) {
+    const wide wa = a;
+    const wide wb = b;
+    const unsigned shift = static_cast<unsigned>(b) % (sizeof(a) * 8 + 3);
+    const unsigned exponent = static_cast<unsigned>(b) % 9;
+    check<T>("negate", wa, 0, T::negate(a), -wa);
+    check<T>("abs", wa, 0, T::abs(a), wa < 0 ? -wa : wa);
+    check<T>("abs_diff", wa, wb, T::abs_diff(a, b), wa > wb ? wa - wb : wb - wa);
+    check<T>("shift_left", wa, shift, T::shift_left(a, shift), reference_multiply(wa, wide{1} << shift));
+    check<T>("square", wa, 0, T::square(a), reference_multiply(wa, wa));
+    check<T>("pow", wa, exponent, T::pow(a, exponent), reference_pow(wa, exponent));
+    check<T>("sqrt", wa, 0, T::sqrt(a), reference_sqrt(wa));
+
+    T x { reference<T>(wa) };
+    check<T>("increment", x, 0, ++x, static_cast<wide>(reference<T>(wa)) + 1);
+    T y { reference<T>(wa) };
+    check<T>("decrement", y, 0, y--, reference<T>(wa));
+    check<T>("decrement", y, 0, y, static_cast<wide>(reference<T>(wa)) - 1);
+}
+
+template <typename... T, typename A, typename B>
+void test_math(const A& a, const B& b) {
+    (test_math_impl<T>(static_cast<typename T::value_type>(a), static_cast<typename T::value_type>(b)), ...);
+}
+
+template <typename S>
+void test_batch(std::mt19937_64& rng, const std::size_t n) {
+    std::vector<S> a(n), b(n), out(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        a[i] = S::from(static_cast<typename S::value_type>(rng()));
+        b[i] = S::from(static_cast<typename S::value_type>(rng()));
+        if (i % 5 == 0) a[i] = S{ S::min_val };
+        if (i % 7 == 0) a[i] = S{ S::max_val };
+    }
+    const unsigned shift = static_cast<unsigned>(rng() % (sizeof(S) * 8 + 3));
+    const unsigned exponent = static_cast<unsigned>(rng() % 5);
+
+    saturating::batch::negate(a.data(), out.data(), n);
+    for (std::size_t i = 0; i < n; ++i) assert(out[i] == S::negate(a[i]));
+    saturating::batch::abs(a.data(), out.data(), n);
+    for (std::size_t i = 0; i < n; ++i) assert(out[i] == S::abs(a[i]));
+    saturating::batch::abs_diff(a.data(), b.data(), out.data(), n);
+    for (std::size_t i = 0; i < n; ++i) assert(out[i] == S::abs_diff(a[i], b[i]));
+    saturating::batch::shift_left(a.data(), out.data(), n, shift);
+    for (std::size_t i = 0; i < n; ++i) assert(out[i] == S::shift_left(a[i], shift));
+    saturating::batch::square(a.data(), out.data(), n);
+    for (std::size_t i = 0; i < n; ++i) assert(out[i] == S::square(a[i]));
+    saturating::batch::pow(a.data(), out.data(), n, exponent);
+    for (std::size_t i = 0; i < n; ++i) assert(out[i] == S::pow(a[i], exponent));
+    saturating::batch::sqrt(a.data(), out.data(), n);
+    for (std::size_t i = 0; i < n; ++i) assert(out[i] == S::sqrt(a[i]));
+    saturating::batch::increment(a.data(), out.data(), n);
+    for (std::size_t i = 0; i < n; ++i) { auto x = a[i]; assert(out[i] == ++x); }
+    saturating::batch::decrement(a.data(), out.data(), n);
+    for (std::size_t i = 0; i < n; ++i) { auto x = a[i]; assert(out[i] == --x); }
+}
+
+using custom_t = saturating::type<int16_t, -1000, 3000>;
+using custom_u_t = saturating::type<uint8_t, 16, 200>;
+
+static_assert(int_sat8_t::negate(int8_t{-128}) == 127);
+static_assert(int_sat32_t::pow(3, 19u) == 1162261467);
+static_assert(int_sat32_t::pow(-3, 21u) == std::numeric_limits<int32_t>::lowest());
+static_assert(int_sat32_t::pow(-5, 3) == -125);
+static_assert(int_sat32_t::pow(7, -1) == 0 && int_sat32_t::pow(0, -2) == 0);
+static_assert(int_sat32_t::pow(1, -3) == 1 && int_sat32_t::pow(-1, -3) == -1 && int_sat32_t::pow(-1, int64_t{ -4 }) == 1);
+static_assert(uint_sat64_t::sqrt(std::numeric_limits<uint64_t>::max()) == 4294967295u);
+static_assert(int_sat16_t::shift_left(-3, 14) == -32768);
+static_assert((-int_sat8_t{-128}) == 127);
+
+int main() {
+    // Every 8 bit pair
+    for (int a = -128; a < 256; ++a) {
+        for (int b = -128; b < 256; ++b) {
+            test_math<int_sat8_t, uint_sat8_t, custom_u_t>(a, b);
+        }
+    }
+
+    const unsigned samples = 1'000'000;
+    std::mt19937_64 rng(29);
+
+    auto start = std::chrono::system_clock::now();
+    for (unsigned i = 0; i <= samples; ++i) {
+        const auto a = rng() >> (rng() % 64);
+        const auto b = rng() >> (rng() % 64);
+        test_math<int_sat16_t, uint_sat16_t, custom_t, int_sat32_t, uint_sat32_t, int_sat64_t, uint_sat64_t>(a, b);
+    }
+    for (unsigned i = 0; i <= 500; ++i) {
+        const std::size_t n = i % 131;
+        test_batch<int_sat8_t>(rng, n);
+        test_batch<uint_sat8_t>(rng, n);
+        test_batch<custom_u_t>(rng, n);
+        test_batch<int_sat16_t>(rng, n);
+        test_batch<uint_sat16_t>(rng, n);
+        test_batch<custom_t>(rng, n);
+        test_batch<int_sat32_t>(rng, n);
+        test_batch<uint_sat32_t>(rng, n);
+        test_batch<int_sat64_t>(rng, n);
+        test_batch<uint_sat64_t>(rng, n);
+    }
+    auto end = std::chrono::system_clock::now();
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+    std::cout << "Math functions took " << elapsed.count() << " ms" << std::endl;
+}
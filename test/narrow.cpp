@@ -0,0 +1,106 @@
+#include <iostream>
+#include <cassert>
+#include <chrono>
+#include <random>
+#include <limits>
+#include <vector>
+#include "../functions.hpp"
+#include "../types.hpp"
+#include "../batch.hpp"
+
+using wide = __int128_t;
+
+// round(val / 2^shift), halfway cases up, using floor division
+wide reference_shift(const wide val, const unsigned shift) {
+    if (shift == 0) return val;
+    const wide divisor = wide{1} << shift;
+    const wide sum = val + divisor / 2;
+    return sum >= 0 ? sum / divisor : -((-sum + divisor - 1) / divisor);
+}
+
+template <typename TOut, typename TIn>
+void test_narrow_impl(const TIn& a, const unsigned shift) {
+    const wide temp = reference_shift(a, shift);
+    const auto r1 = static_cast<typename TOut::value_type>(temp < TOut::min_val ? TOut::min_val : (temp > TOut::max_val ? TOut::max_val : temp));
+    const auto r2 = TOut::rounding_shift_right(a, shift);
+    if (r1 != r2) {
+        std::cout << "Error calculating " << +a << " >> " << shift
+                  << " (" << +TOut::min_val << "..." << +TOut::max_val << "): " << +r2
+                  << ", expected " << +r1 << std::endl;
+        assert(r1 == r2);
+    }
+}
+
+template <typename... TOut, typename TIn>
+void test_narrow(const TIn& a, const unsigned shift) {
+    (test_narrow_impl<TOut>(a, shift), ...);
+}
+
+template <typename SIn, typename SOut>
+void test_batch(std::mt19937_64& rng, const std::size_t n) {
+    std::vector<SIn> in(n);
+    std::vector<SOut> out(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        in[i] = SIn{ static_cast<typename SIn::value_type>(rng()) };
+    }
+    const unsigned shift = static_cast<unsigned>(rng() % (sizeof(SIn) * 8 + 2));
+    saturating::batch::rounding_shift_right(in.data(), out.data(), n, shift);
+    for (std::size_t i = 0; i < n; ++i) {
+        assert(out[i] == SOut::rounding_shift_right(in[i], shift));
+    }
+}
+
+template <typename SIn, typename... SOut>
+void test_batch_pairs(std::mt19937_64& rng, const std::size_t n) {
+    (test_batch<SIn, SOut>(rng, n), ...);
+}
+
+using custom_t = saturating::type<int8_t, -100, 100>;
+using custom_u_t = saturating::type<uint16_t, 1000, 2000>;
+
+static_assert(int_sat16_t::rounding_shift_right(int32_t{0x7fffffff}, 15) == 32767);
+static_assert(int_sat16_t::rounding_shift_right(int32_t{-98304}, 15) == -3);
+static_assert(int_sat16_t::rounding_shift_right(int32_t{49152}, 15) == 2);
+static_assert(int_sat16_t::rounding_shift_right(int32_t{-49152}, 15) == -1);
+static_assert(uint_sat8_t::rounding_shift_right(int16_t{-5}, 1) == 0);
+static_assert(uint_sat8_t::rounding_shift_right(uint8_t{128}, 8) == 1);
+
+int main() {
+    // Every 16 bit input for every shift
+    for (unsigned shift = 0; shift <= 18; ++shift) {
+        for (int a = std::numeric_limits<int16_t>::lowest(); a <= std::numeric_limits<uint16_t>::max(); ++a) {
+            if (a <= std::numeric_limits<int16_t>::max()) {
+                test_narrow<int_sat8_t, uint_sat8_t, custom_t, int_sat16_t, custom_u_t>(static_cast<int16_t>(a), shift);
+            }
+            if (a >= 0) {
+                test_narrow<int_sat8_t, uint_sat8_t, custom_t, int_sat16_t, custom_u_t>(static_cast<uint16_t>(a), shift);
+            }
+        }
+    }
+
+    const unsigned samples = 1'000'000;
+    std::mt19937_64 rng(30);
+
+    auto start = std::chrono::system_clock::now();
+    for (unsigned i = 0; i <= samples; ++i) {
+        const auto r = rng();
+        const unsigned shift = static_cast<unsigned>(rng() % 66);
+        test_narrow<int_sat8_t, uint_sat8_t, int_sat16_t, uint_sat16_t, custom_u_t, int_sat32_t, uint_sat32_t>(static_cast<int32_t>(r), shift);
+        test_narrow<int_sat8_t, uint_sat8_t, int_sat16_t, uint_sat16_t, int_sat32_t, uint_sat32_t>(static_cast<uint32_t>(r), shift);
+        test_narrow<int_sat16_t, int_sat32_t, uint_sat32_t, int_sat64_t>(static_cast<int64_t>(r), shift);
+        test_narrow<uint_sat16_t, int_sat32_t, uint_sat32_t, uint_sat64_t>(static_cast<uint64_t>(r), shift);
+    }
+    for (unsigned i = 0; i <= 500; ++i) {
+        const std::size_t n = i % 131;
+        test_batch_pairs<int_sat16_t, int_sat8_t, uint_sat8_t, custom_t, int_sat16_t>(rng, n);
+        test_batch_pairs<uint_sat16_t, int_sat8_t, uint_sat8_t, custom_u_t>(rng, n);
+        test_batch_pairs<int_sat32_t, int_sat8_t, int_sat16_t, uint_sat16_t, custom_u_t, int_sat64_t>(rng, n);
+        test_batch_pairs<uint_sat32_t, uint_sat8_t, int_sat16_t, uint_sat16_t>(rng, n);
+        test_batch_pairs<int_sat64_t, int_sat16_t, int_sat32_t, uint_sat32_t>(rng, n);
+        test_batch_pairs<uint_sat64_t, uint_sat32_t, int_sat32_t>(rng, n);
+        test_batch_pairs<int_sat8_t, saturating::type<int16_t, 300, 400>>(rng, n);
+    }
+    auto end = std::chrono::system_clock::now();
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+    std::cout << "Narrowing took " << elapsed.count() << " ms" << std::endl;
+}
@@ -0,0 +1,154 @@
+#include <iostream>
+#include <cassert>
+#include <chrono>
+#include <random>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+#include "../types.hpp"
+#include "../batch.hpp"
+#include "../pipeline.hpp"
+
+namespace pipeline = saturating::pipeline;
+
+template <typename S>
+void check(const std::vector<S>& out, const std::vector<S>& expected, const char* what) {
+    assert(out.size() == expected.size());
+    for (std::size_t i = 0; i < out.size(); ++i) {
+        if (out[i] != expected[i]) {
+            std::cout << "Error in " << what << " at " << i << ": " << +static_cast<typename S::value_type>(out[i])
+                      << ", expected " << +static_cast<typename S::value_type>(expected[i]) << std::endl;
+            assert(out[i] == expected[i]);
+        }
+    }
+}
+
+/** Feed `in` to `p` in irregular pieces and collect the results. */
+template <typename P, typename In, typename Out>
+std::vector<Out> stream(P&& p, const std::vector<In>& in) {
+    std::vector<Out> out;
+    std::size_t pos = 0, piece = 0;
+    const std::size_t total = pipeline::run(p,
+        [&](In* buffer, std::size_t max) noexcept {
+            const std::size_t count = std::min({ max, in.size() - pos, ++piece * 37 });
+            std::copy(in.begin() + pos, in.begin() + pos + count, buffer);
+            pos += count;
+            return count;
+        },
+        [&](const Out* buffer, std::size_t n) { out.insert(out.end(), buffer, buffer + n); });
+    assert(total == in.size());
+    return out;
+}
+
+int main() {
+    std::mt19937_64 rng(33);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    const std::size_t n = 100'003;
+
+    {
+        std::vector<float_sat_t> in(n);
+        for (auto& v : in) v = float_sat_t{ dist(rng) };
+
+        const auto p = pipeline::chain(pipeline::gain<float_sat_t>(1.7f),
+                                       pipeline::offset<float_sat_t>(0.2f),
+                                       pipeline::clip<float_sat_t>(-0.9f, 0.9f),
+                                       pipeline::scale_from<float_sat_t, int_sat16_t>());
+
+        std::vector<int_sat16_t> expected(n), out(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            float x = saturating::clamp(-1.0f, static_cast<float>(in[i]) * 1.7f, 1.0f);
+            x = saturating::clamp(-1.0f, x + 0.2f, 1.0f);
+            x = saturating::clamp(-0.9f, x, 0.9f);
+            expected[i] = int_sat16_t::scale_from(float_sat_t{ x });
+        }
+        static_assert(noexcept(p(in.data(), out.data(), n)));
+        p(in.data(), out.data(), n);
+        check(out, expected, "floating point chain");
+        check(stream<decltype(p)&, float_sat_t, int_sat16_t>(p, in), expected, "streamed floating point chain");
+    }
+
+    {
+        std::vector<int_sat32_t> in(n);
+        for (auto& v : in) v = int_sat32_t{ static_cast<int32_t>(rng()) >> 8 };
+
+        const auto p = pipeline::chain(pipeline::gain<int_sat32_t>(300),
+                                       pipeline::offset<int_sat32_t>(-1000),
+                                       pipeline::clip<int_sat32_t>(-(1 << 28), std::numeric_limits<int32_t>::max()),
+                                       pipeline::narrow<int_sat32_t, int_sat16_t>(12),
+                                       pipeline::map<int_sat16_t, uint_sat8_t>([](int_sat16_t x) noexcept { return uint_sat8_t::abs_diff(x, int16_t{ 100 }); }));
+
+        std::vector<uint_sat8_t> expected(n), out(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            int_sat32_t x = int_sat32_t::multiply(in[i], 300);
+            x = int_sat32_t::add(x, -1000);
+            x = int_sat32_t{ saturating::clamp(-(1 << 28), static_cast<int32_t>(x), std::numeric_limits<int32_t>::max()) };
+            expected[i] = uint_sat8_t::abs_diff(int_sat16_t::rounding_shift_right(x, 12), int16_t{ 100 });
+        }
+        p(in.data(), out.data(), n);
+        check(out, expected, "integral chain");
+        check(stream<decltype(p)&, int_sat32_t, uint_sat8_t>(p, in), expected, "streamed integral chain");
+
+        // In place, single type
+        const auto q = pipeline::chain(pipeline::gain<int_sat32_t>(-3), pipeline::offset<int_sat32_t>(7));
+        std::vector<int_sat32_t> inout = in, expected_q(n);
+        for (std::size_t i = 0; i < n; ++i) expected_q[i] = int_sat32_t::add(int_sat32_t::multiply(in[i], -3), 7);
+        q(inout.data(), inout.data(), n);
+        check(inout, expected_q, "in place chain");
+    }
+
+    {
+        // A stateful (mutable) map runs in a non-const chain and keeps its state across calls
+        std::vector<int_sat32_t> in(n, int_sat32_t{ 1 }), out(n), expected(n);
+        auto running = pipeline::chain(pipeline::map<int_sat32_t, int_sat32_t>([sum = int_sat32_t{ 0 }](int_sat32_t x) mutable noexcept { return sum += x; }));
+        static_assert(noexcept(running(in.data(), out.data(), n)));
+        running(in.data(), out.data(), n);
+        for (std::size_t i = 0; i < n; ++i) expected[i] = int_sat32_t{ static_cast<int32_t>(i + 1) };
+        check(out, expected, "mutable map");
+        for (std::size_t i = 0; i < n; ++i) expected[i] = int_sat32_t{ static_cast<int32_t>(n + i + 1) };
+        check(stream<decltype(running)&, int_sat32_t, int_sat32_t>(running, in), expected, "streamed mutable map");
+
+        // Exceptions of a callable propagate instead of terminating
+        const auto strict = pipeline::chain(pipeline::offset<int_sat32_t>(50'000),
+                                            pipeline::map<int_sat32_t, int_sat32_t>([](int_sat32_t x) {
+                                                if (x > 100'000) throw std::out_of_range("above 100000");
+                                                return x;
+                                            }));
+        static_assert(!noexcept(strict(in.data(), out.data(), n)));
+        bool thrown = false;
+        try {
+            strict(expected.data(), out.data(), n);
+        } catch (const std::out_of_range&) {
+            thrown = true;
+        }
+        assert(thrown);
+    }
+
+    const std::size_t samples = 1 << 24;
+    std::vector<float_sat_t> in(samples), tmp(samples);
+    std::vector<int_sat16_t> out(samples);
+    for (auto& v : in) v = float_sat_t{ dist(rng) };
+
+    const auto separate = [&]() {
+        saturating::batch::multiply(in.data(), 1.7f, tmp.data(), samples);
+        saturating::batch::add(tmp.data(), 0.2f, tmp.data(), samples);
+        saturating::batch::clip(tmp.data(), tmp.data(), samples, -0.9f, 0.9f);
+        for (std::size_t i = 0; i < samples; ++i) out[i] = int_sat16_t::scale_from(tmp[i]);
+    };
+    separate(); // Fault in all pages first
+
+    auto start = std::chrono::system_clock::now();
+    separate();
+    auto end = std::chrono::system_clock::now();
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+    std::cout << "Separate passes took " << elapsed.count() << " ms" << std::endl;
+
+    const auto p = pipeline::chain(pipeline::gain<float_sat_t>(1.7f),
+                                   pipeline::offset<float_sat_t>(0.2f),
+                                   pipeline::clip<float_sat_t>(-0.9f, 0.9f),
+                                   pipeline::scale_from<float_sat_t, int_sat16_t>());
+    start = std::chrono::system_clock::now();
+    p(in.data(), out.data(), samples);
+    end = std::chrono::system_clock::now();
+    elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+    std::cout << "Fused pipeline took " << elapsed.count() << " ms" << std::endl;
+}
@@ -0,0 +1,152 @@
+#include <iostream>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <cfenv>
+#include <random>
+#include <limits>
+#include <vector>
+#include "../types.hpp"
+#include "../quantize.hpp"
+
+static_assert(saturating::round_half_even(2.5) == 2.0);
+static_assert(saturating::round_half_even(3.5f) == 4.0f);
+static_assert(saturating::round_half_even(-2.5) == -2.0);
+static_assert(saturating::round_half_even(-0.75f) == -1.0f);
+static_assert(saturating::quantize<int_sat8_t>(0.25f, 0.1f, int8_t{ 3 }) == 5);
+static_assert(saturating::quantize<uint_sat8_t>(-1e30f, 0.1f, uint8_t{ 128 }) == 0);
+
+/** Plain reference: `std::nearbyint` in the default rounding mode, clamped in double. */
+template <typename S, typename F>
+S reference_quantize(const F x, const F scale, const typename S::value_type zero_point) {
+    using T = typename S::value_type;
+    const F v = x / scale;
+    if (std::isnan(v)) return S{ saturating::clamp(S::min_val, zero_point, S::max_val) };
+    const double q = std::min<double>(std::max<double>(std::nearbyint(static_cast<double>(v)) + zero_point, S::min_val), S::max_val);
+    return S{ static_cast<T>(q) };
+}
+
+template <typename F>
+std::vector<F> values(std::mt19937_64& rng, std::size_t n, const F scale) {
+    std::uniform_real_distribution<F> dist(-300, 300);
+    std::vector<F> in(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        switch (i % 9) {
+            case 0: in[i] = (static_cast<F>(static_cast<int>(rng() % 601) - 300) + F(0.5)) * scale; break; // Halfway cases
+            case 1: in[i] = static_cast<F>(static_cast<int>(rng() % 40001) - 20000) * scale; break;
+            default: in[i] = dist(rng) * scale; break;
+        }
+    }
+    for (const F special : { std::numeric_limits<F>::quiet_NaN(), -std::numeric_limits<F>::quiet_NaN(),
+                             std::numeric_limits<F>::infinity(), -std::numeric_limits<F>::infinity(),
+                             std::numeric_limits<F>::max(), std::numeric_limits<F>::lowest(), F(0), F(-0.0) }) {
+        if (n > 0) in[rng() % n] = special;
+    }
+    return in;
+}
+
+template <typename S, typename F>
+void test_tensor(std::mt19937_64& rng, std::size_t n, const F scale, const typename S::value_type zero_point) {
+    const auto in = values(rng, n, scale);
+    std::vector<S> out(n), expected(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        expected[i] = saturating::quantize<S>(in[i], scale, zero_point);
+        assert(expected[i] == reference_quantize<S>(in[i], scale, zero_point));
+    }
+    saturating::quantize(in.data(), out.data(), n, scale, zero_point);
+    for (std::size_t i = 0; i < n; ++i) {
+        if (out[i] != expected[i]) {
+            std::cout << "Error quantizing " << in[i] << " at " << i << ": " << +static_cast<typename S::value_type>(out[i])
+                      << ", expected " << +static_cast<typename S::value_type>(expected[i]) << std::endl;
+            assert(out[i] == expected[i]);
+        }
+    }
+
+    std::vector<F> back(n);
+    saturating::dequantize(out.data(), back.data(), n, scale, zero_point);
+    for (std::size_t i = 0; i < n; ++i) {
+        assert(back[i] == saturating::dequantize(out[i], scale, zero_point));
+        // Values within range come back within half a step
+        const F x = in[i];
+        if (x == x && x / scale + zero_point > S::min_val && x / scale + zero_point < S::max_val) {
+            assert(std::fabs(back[i] - x) <= scale * F(0.5001));
+        }
+    }
+}
+
+template <typename S, typename F>
+void test_channels(std::mt19937_64& rng, std::size_t outer, std::size_t channels, std::size_t inner) {
+    using T = typename S::value_type;
+    std::vector<F> scales(channels);
+    std::vector<T> zero_points(channels);
+    for (std::size_t c = 0; c < channels; ++c) {
+        scales[c] = static_cast<F>(0.001 + (rng() % 1000) / 997.0);
+        zero_points[c] = static_cast<T>(rng());
+    }
+    const std::size_t n = outer * channels * inner;
+    const auto in = values(rng, n, F(0.5));
+    std::vector<S> out(n);
+    std::vector<F> back(n);
+    saturating::quantize(in.data(), out.data(), outer, channels, inner, scales.data(), zero_points.data());
+    saturating::dequantize(out.data(), back.data(), outer, channels, inner, scales.data(), zero_points.data());
+    for (std::size_t i = 0; i < n; ++i) {
+        const std::size_t c = (i / inner) % channels;
+        assert(out[i] == saturating::quantize<S>(in[i], scales[c], zero_points[c]));
+        assert(back[i] == saturating::dequantize(out[i], scales[c], zero_points[c]));
+    }
+}
+
+template <typename S, typename F>
+void test_type(std::mt19937_64& rng) {
+    using T = typename S::value_type;
+    for (const std::size_t n : { 0, 1, 7, 31, 32, 33, 1000, 4099 }) {
+        test_tensor<S, F>(rng, n, F(0.05), T{ 0 });
+        test_tensor<S, F>(rng, n, F(1), std::numeric_limits<T>::max());
+        test_tensor<S, F>(rng, n, F(0.0037), static_cast<T>(rng()));
+        test_tensor<S, F>(rng, n, F(3), std::numeric_limits<T>::lowest());
+    }
+    for (const std::size_t channels : { 1, 3, 8, 37 }) {
+        test_channels<S, F>(rng, 5, channels, 1);
+        test_channels<S, F>(rng, 3, channels, 19);
+        test_channels<S, F>(rng, 2, channels, 64);
+    }
+}
+
+int main() {
+    assert(std::fegetround() == FE_TONEAREST);
+    std::mt19937_64 rng(35);
+
+    test_type<int_sat8_t, float>(rng);
+    test_type<uint_sat8_t, float>(rng);
+    test_type<int_sat16_t, float>(rng);
+    test_type<uint_sat16_t, float>(rng);
+    test_type<saturating::type<int8_t, -127, 127>, float>(rng);
+    test_type<saturating::type<uint8_t, 0, 15>, float>(rng);
+    test_type<int_sat8_t, double>(rng);
+    test_type<uint_sat16_t, double>(rng);
+
+    const std::size_t samples = 1 << 24;
+    const float scale = 0.02f;
+    std::vector<float> in(samples), back(samples);
+    std::vector<int_sat8_t> scalar(samples), out(samples);
+    std::uniform_real_distribution<float> dist(-3, 3);
+    for (auto& v : in) v = dist(rng);
+
+    auto start = std::chrono::system_clock::now();
+    for (std::size_t i = 0; i < samples; ++i) scalar[i] = int_sat8_t::from(in[i] / scale + 5);
+    auto end = std::chrono::system_clock::now();
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+    std::cout << "Per element from() quantization took " << elapsed.count() << " ms" << std::endl;
+
+    start = std::chrono::system_clock::now();
+    saturating::quantize(in.data(), out.data(), samples, scale, int8_t{ 5 });
+    end = std::chrono::system_clock::now();
+    elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+    std::cout << "Batch quantization took " << elapsed.count() << " ms" << std::endl;
+
+    start = std::chrono::system_clock::now();
+    saturating::dequantize(out.data(), back.data(), samples, scale, int8_t{ 5 });
+    end = std::chrono::system_clock::now();
+    elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+    std::cout << "Batch dequantization took " << elapsed.count() << " ms" << std::endl;
+}
@@ -0,0 +1,117 @@
+#include <iostream>
+#include <cassert>
+#include <chrono>
+#include <random>
+#include <limits>
+#include <vector>
+#include "../types.hpp"
+#include "../sad.hpp"
+
+/** Scalar reference on exact differences (`abs_diff` of the type itself saturates to its range). */
+template <typename S, bool SQUARE>
+uint64_t reference(const S* a, std::size_t a_stride, const S* b, std::size_t b_stride, std::size_t width, std::size_t height) {
+    uint64_t total = 0;
+    for (std::size_t r = 0; r < height; ++r) {
+        for (std::size_t c = 0; c < width; ++c) {
+            const int64_t d = static_cast<int64_t>(static_cast<typename S::value_type>(a[r * a_stride + c]))
+                              - static_cast<int64_t>(static_cast<typename S::value_type>(b[r * b_stride + c]));
+            total += static_cast<uint64_t>(SQUARE ? d * d : (d < 0 ? -d : d));
+        }
+    }
+    return total;
+}
+
+template <typename S>
+void test_blocks(std::mt19937_64& rng) {
+    using T = typename S::value_type;
+    const auto random_block = [&](std::size_t size) {
+        std::vector<S> v(size);
+        for (auto& x : v) x = S::from(static_cast<T>(rng()));
+        return v;
+    };
+
+    for (int i = 0; i < 300; ++i) {
+        const std::size_t width = rng() % 80, height = rng() % 9;
+        const std::size_t a_stride = width + rng() % 5, b_stride = width + rng() % 5;
+        const auto a = random_block(a_stride * height + 1), b = random_block(b_stride * height + 1);
+        const S* pa = a.data() + 1;  // Misaligned
+        assert((saturating::sad(pa, a_stride, b.data(), b_stride, width, height) == reference<S, false>(pa, a_stride, b.data(), b_stride, width, height)));
+        assert((saturating::ssd(pa, a_stride, b.data(), b_stride, width, height) == reference<S, true>(pa, a_stride, b.data(), b_stride, width, height)));
+    }
+
+    // Extreme values over rows long enough to need the accumulator flushes
+    const std::size_t width = 1 << 20;
+    std::vector<S> lo(width, S::from(S::min_val)), hi(width, S::from(S::max_val));
+    const uint64_t range = static_cast<uint64_t>(static_cast<int64_t>(S::max_val) - static_cast<int64_t>(S::min_val));
+    assert(saturating::sad(lo.data(), width, hi.data(), width, width, 1) == range * width);
+    assert(saturating::ssd(hi.data(), width, lo.data(), width, width, 1) == range * range * width);
+
+    // Sliding window against the per block sums
+    const std::size_t bw = 16, bh = 8, cols = 1 + rng() % 24, rows = 1 + rng() % 10;
+    const std::size_t area_stride = bw + cols - 1 + rng() % 3;
+    const auto block = random_block(bw * bh), area = random_block(area_stride * (bh + rows - 1));
+    std::vector<uint64_t> sads(cols * rows), ssds(cols * rows);
+    saturating::sad_map(block.data(), bw, area.data(), area_stride, bw, bh, cols, rows, sads.data());
+    saturating::ssd_map(block.data(), bw, area.data(), area_stride, bw, bh, cols, rows, ssds.data());
+    for (std::size_t y = 0; y < rows; ++y) {
+        for (std::size_t x = 0; x < cols; ++x) {
+            const S* at = area.data() + y * area_stride + x;
+            assert((sads[y * cols + x] == reference<S, false>(block.data(), bw, at, area_stride, bw, bh)));
+            assert((ssds[y * cols + x] == reference<S, true>(block.data(), bw, at, area_stride, bw, bh)));
+        }
+    }
+}
+
+int main() {
+    std::mt19937_64 rng(38);
+    test_blocks<uint_sat8_t>(rng);
+    test_blocks<int_sat8_t>(rng);
+    test_blocks<uint_sat16_t>(rng);
+    test_blocks<int_sat16_t>(rng);
+    test_blocks<saturating::type<uint8_t, 16, 235>>(rng);
+    test_blocks<saturating::type<int16_t, -1000, 30000>>(rng);
+
+    // Full search of 16x16 blocks over a +-16 pixel window of a frame
+    const std::size_t frame_width = 1920, frame_height = 1080, size = 16, range = 33;
+    std::vector<uint_sat8_t> frame(frame_width * frame_height), previous(frame_width * frame_height);
+    for (std::size_t i = 0; i < frame.size(); ++i) {
+        previous[i] = uint_sat8_t::from(static_cast<uint8_t>(rng()));
+        frame[i] = uint_sat8_t::from(static_cast<uint8_t>(static_cast<uint8_t>(previous[i]) + rng() % 8));
+    }
+    const std::size_t blocks = 256;
+    std::vector<uint64_t> naive(blocks * range * range), kernel(blocks * range * range);
+    const auto origin = [&](std::size_t k) { return (size * 2 + (k / 16) * size * 3) * frame_width + size * 2 + (k % 16) * size * 6; };
+
+    auto start = std::chrono::system_clock::now();
+    for (std::size_t k = 0; k < blocks; ++k) {
+        const uint_sat8_t* block = frame.data() + origin(k);
+        const uint_sat8_t* area = previous.data() + origin(k) - size * frame_width - size;
+        for (std::size_t y = 0; y < range; ++y) {
+            for (std::size_t x = 0; x < range; ++x) {
+                uint64_t total = 0;
+                for (std::size_t r = 0; r < size; ++r) {
+                    for (std::size_t c = 0; c < size; ++c) {
+                        const int d = static_cast<int>(static_cast<uint8_t>(block[r * frame_width + c]))
+                                      - static_cast<uint8_t>(area[(y + r) * frame_width + x + c]);
+                        total += static_cast<uint64_t>(d < 0 ? -d : d);
+                    }
+                }
+                naive[(k * range + y) * range + x] = total;
+            }
+        }
+    }
+    auto end = std::chrono::system_clock::now();
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+    std::cout << "Subtract and abs took " << elapsed.count() << " ms" << std::endl;
+
+    start = std::chrono::system_clock::now();
+    for (std::size_t k = 0; k < blocks; ++k) {
+        saturating::sad_map(frame.data() + origin(k), frame_width, previous.data() + origin(k) - size * frame_width - size, frame_width,
+                            size, size, range, range, kernel.data() + k * range * range);
+    }
+    end = std::chrono::system_clock::now();
+    elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+    std::cout << "SAD kernel took " << elapsed.count() << " ms" << std::endl;
+
+    assert(naive == kernel);
+}
@@ -0,0 +1,131 @@
+#include <iostream>
+#include <cassert>
+#include <chrono>
+#include <random>
+#include <limits>
+#include <vector>
+#include "../types.hpp"
+#include "../scan.hpp"
+
+template <typename S, typename U>
+void check(const std::vector<S>& out, const std::vector<S>& expected, const char* what, std::size_t n, unsigned threads) {
+    for (std::size_t i = 0; i < n; ++i) {
+        if (out[i] != expected[i]) {
+            std::cout << "Error in " << what << " of " << n << " elements (" << threads << " threads) at " << i << ": "
+                      << +static_cast<typename S::value_type>(out[i]) << ", expected " << +static_cast<typename S::value_type>(expected[i]) << std::endl;
+            assert(out[i] == expected[i]);
+        }
+    }
+}
+
+template <typename S>
+S saturate(const __int128 val) {
+    using T = typename S::value_type;
+    return S{ static_cast<T>(val < S::min_val ? S::min_val : (val > S::max_val ? S::max_val : val)) };
+}
+
+/** Compare against sums saturated after every step, and the wide policy against exact sums. */
+template <typename S, typename U>
+void test_scan(std::mt19937_64& rng, std::size_t n, unsigned threads, const S& init) {
+    using V = std::decay_t<U>;
+    std::vector<U> in(n);
+    // Long runs of one sign drive the sums into both limits
+    for (std::size_t i = 0; i < n; ++i) {
+        const bool up = (i / 1000) % 2;
+        const auto r = static_cast<V>(rng());
+        in[i] = U{ up ? (r < 0 ? static_cast<V>(-(r + 1)) : r) : (r > 0 ? static_cast<V>(-r) : r) };
+    }
+
+    std::vector<S> expected(n), out(n);
+    S acc = init;
+    for (std::size_t i = 0; i < n; ++i) {
+        acc = saturate<S>(static_cast<__int128>(acc) + static_cast<V>(in[i]));
+        expected[i] = acc;
+    }
+    saturating::inclusive_scan(in.data(), out.data(), n, init, threads);
+    check<S, U>(out, expected, "inclusive scan", n, threads);
+
+    acc = init;
+    for (std::size_t i = 0; i < n; ++i) {
+        expected[i] = acc;
+        acc = saturate<S>(static_cast<__int128>(acc) + static_cast<V>(in[i]));
+    }
+    saturating::exclusive_scan(in.data(), out.data(), n, init, threads);
+    check<S, U>(out, expected, "exclusive scan", n, threads);
+    if constexpr (std::is_same_v<U, S>) {
+        std::vector<S> inout = in;
+        saturating::exclusive_scan(inout.data(), inout.data(), n, init, threads);
+        check<S, U>(inout, expected, "in place exclusive scan", n, threads);
+    }
+
+    if (n > 0) {
+        acc = saturate<S>(static_cast<V>(in[0]));
+        expected[0] = acc;
+        for (std::size_t i = 1; i < n; ++i) {
+            acc = saturate<S>(static_cast<__int128>(acc) + static_cast<V>(in[i]));
+            expected[i] = acc;
+        }
+        saturating::inclusive_scan(in.data(), out.data(), n, threads);
+        check<S, U>(out, expected, "inclusive scan without init", n, threads);
+    }
+
+    __int128 sum = static_cast<typename S::value_type>(init);
+    for (std::size_t i = 0; i < n; ++i) {
+        sum += static_cast<V>(in[i]);
+        expected[i] = saturate<S>(sum);
+    }
+    saturating::inclusive_scan<saturating::scan_policy::wide>(in.data(), out.data(), n, init, threads);
+    check<S, U>(out, expected, "wide inclusive scan", n, threads);
+}
+
+template <typename S, typename U>
+void test_sizes(std::mt19937_64& rng, const S& init) {
+    for (const std::size_t n : { 0, 1, 2, 1000, 200'000, 300'001 }) {
+        for (unsigned threads = 1; threads <= 4; ++threads) {
+            test_scan<S, U>(rng, n, threads, init);
+        }
+    }
+}
+
+int main() {
+    std::mt19937_64 rng(32);
+
+    test_sizes<int_sat8_t, int8_t>(rng, int_sat8_t{ 0 });
+    test_sizes<int_sat8_t, int_sat8_t>(rng, int_sat8_t{ 100 });
+    test_sizes<uint_sat8_t, int16_t>(rng, uint_sat8_t{ 7 });
+    test_sizes<saturating::type<int8_t, 10, 100>, int8_t>(rng, saturating::type<int8_t, 10, 100>{ 50 });
+    test_sizes<saturating::type<int16_t, -1000, -10>, int32_t>(rng, saturating::type<int16_t, -1000, -10>{ -10 });
+    test_sizes<int_sat32_t, int32_t>(rng, int_sat32_t{ 0 });
+    test_sizes<uint_sat32_t, int64_t>(rng, uint_sat32_t{ 0 });
+    test_sizes<int_sat64_t, int64_t>(rng, int_sat64_t{ std::numeric_limits<int64_t>::lowest() });
+    test_sizes<uint_sat64_t, int64_t>(rng, uint_sat64_t{ 0 });
+    test_sizes<int_sat64_t, uint64_t>(rng, int_sat64_t{ -5 });
+
+    const std::size_t samples = 50'000'000;
+    std::vector<int32_t> in(samples);
+    std::vector<int_sat32_t> serial(samples), out(samples);
+    for (auto& v : in) v = static_cast<int32_t>(rng()) >> 4;
+
+    auto start = std::chrono::system_clock::now();
+    int_sat32_t acc;
+    for (std::size_t i = 0; i < samples; ++i) {
+        acc += in[i];
+        serial[i] = acc;
+    }
+    auto end = std::chrono::system_clock::now();
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+    std::cout << "Serial += scan took " << elapsed.count() << " ms" << std::endl;
+
+    start = std::chrono::system_clock::now();
+    saturating::inclusive_scan(in.data(), out.data(), samples);
+    end = std::chrono::system_clock::now();
+    elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+    std::cout << "Parallel scan took " << elapsed.count() << " ms" << std::endl;
+    assert(out == serial);
+
+    start = std::chrono::system_clock::now();
+    saturating::inclusive_scan<saturating::scan_policy::wide>(in.data(), out.data(), samples);
+    end = std::chrono::system_clock::now();
+    elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+    std::cout << "Parallel wide scan took " << elapsed.count() << " ms" << std::endl;
+}
@@ -12,6 +12,7 @@
  * TODO: Add non-static functions
  * TODO: Add member `scale_to` function
  * TODO: See if there is any way to allow non integral limits for floating point based types
+ *       (the `batch` kernels in `batch.hpp` take floating point limits at runtime)
  * TODO: Verify floating point based types
  */
 
@@ -78,7 +79,7 @@ namespace saturating {
         static constexpr
         std::enable_if_t<std::is_arithmetic_v<UA> && std::is_arithmetic_v<UB>, type>
         __attribute__((const))
-        add(const UA& a, const UB& b) noexcept {
+        add(const UA a, const UB b) noexcept {
             return { saturating::add<value_type, MIN, MAX, UA, UB>(a, b) };
         }
 
@@ -92,7 +93,7 @@ namespace saturating {
         static constexpr
         std::enable_if_t<std::is_arithmetic_v<UA> && std::is_arithmetic_v<UB>, type>
         __attribute__((const))
-        subtract(const UA& a, const UB& b) noexcept {
+        subtract(const UA a, const UB b) noexcept {
             return { saturating::subtract<value_type, MIN, MAX>(a, b) };
         }
 
@@ -106,7 +107,7 @@ namespace saturating {
         static constexpr
         std::enable_if_t<std::is_arithmetic_v<UA> && std::is_arithmetic_v<UB>, type>
         __attribute__((const))
-        multiply(const UA& a, const UB& b) noexcept {
+        multiply(const UA a, const UB b) noexcept {
             return { saturating::multiply<value_type, MIN, MAX>(a, b) };
         }
 
@@ -120,55 +121,174 @@ namespace saturating {
         static constexpr
         std::enable_if_t<std::is_arithmetic_v<UA> && std::is_arithmetic_v<UB>, type>
         __attribute__((const))
-        divide(const UA& a, const UB& b) noexcept {
+        divide(const UA a, const UB b) noexcept {
             return { saturating::divide<value_type, MIN, MAX>(a, b) };
         }
 
+        /**
+         * Remainder of `a / b` (sign of `a`, zero for a divisor of -1, `a` for a zero divisor) as a new saturating type.
+         * @param  a LHS
+         * @param  b RHS
+         * @return   New saturating type
+         */
+        template <typename UA, typename UB>
+        static constexpr
+        std::enable_if_t<std::is_arithmetic_v<UA> && std::is_arithmetic_v<UB>, type>
+        __attribute__((const))
+        modulo(const UA a, const UB b) noexcept {
+            return { saturating::modulo<value_type, MIN, MAX>(a, b) };
+        }
+
+        /**
+         * Negate `a` and return a new saturating type.
+         * @param  a Operand
+         * @return   New saturating type
+         */
+        template <typename U>
+        static constexpr std::enable_if_t<std::is_arithmetic_v<U>, type>
+        __attribute__((const))
+        negate(const U a) noexcept {
+            return { saturating::negate<value_type, MIN, MAX>(a) };
+        }
+
+        /**
+         * Absolute value of `a` as a new saturating type.
+         * @param  a Operand
+         * @return   New saturating type
+         */
+        template <typename U>
+        static constexpr std::enable_if_t<std::is_arithmetic_v<U>, type>
+        __attribute__((const))
+        abs(const U a) noexcept {
+            return { saturating::abs<value_type, MIN, MAX>(a) };
+        }
+
+        /**
+         * Absolute difference of `a` and `b` as a new saturating type.
+         * @param  a LHS
+         * @param  b RHS
+         * @return   New saturating type
+         */
+        template <typename UA, typename UB>
+        static constexpr std::enable_if_t<std::is_arithmetic_v<UA> && std::is_arithmetic_v<UB>, type>
+        __attribute__((const))
+        abs_diff(const UA a, const UB b) noexcept {
+            return { saturating::abs_diff<value_type, MIN, MAX>(a, b) };
+        }
+
+        /**
+         * Shift `a` left by `shift` bits and return a new saturating type.
+         * @param  a     Integral operand
+         * @param  shift Number of bits
+         * @return       New saturating type
+         */
+        template <typename U>
+        static constexpr std::enable_if_t<std::is_integral_v<U> && std::is_integral_v<value_type>, type>
+        __attribute__((const))
+        shift_left(const U a, unsigned shift) noexcept {
+            return { saturating::shift_left<value_type, MIN, MAX>(a, shift) };
+        }
+
+        /**
+         * Square `a` and return a new saturating type.
+         * @param  a Operand
+         * @return   New saturating type
+         */
+        template <typename U>
+        static constexpr std::enable_if_t<std::is_arithmetic_v<U>, type>
+        __attribute__((const))
+        square(const U a) noexcept {
+            return { saturating::square<value_type, MIN, MAX>(a) };
+        }
+
+        /**
+         * Raise `a` to the power `exponent` and return a new saturating type.
+         * @param  a        Base
+         * @param  exponent Exponent of any integral type, see `saturating::pow` for negative ones
+         * @return          New saturating type
+         */
+        template <typename U, typename E>
+        static constexpr std::enable_if_t<std::is_arithmetic_v<U> && std::is_integral_v<E> && !std::is_same_v<E, bool>, type>
+        __attribute__((const))
+        pow(const U a, const E exponent) noexcept {
+            return { saturating::pow<value_type, MIN, MAX>(a, exponent) };
+        }
+
+        /**
+         * Square root of `a` (rounded down for integral types) as a new saturating type.
+         * @param  a Operand
+         * @return   New saturating type
+         */
+        template <typename U>
+        static constexpr std::enable_if_t<std::is_arithmetic_v<U>, type>
+        __attribute__((const))
+        sqrt(const U a) noexcept {
+            return { saturating::sqrt<value_type, MIN, MAX>(a) };
+        }
+
+        /**
+         * Shift `a` right by `shift` bits with rounding, saturating into this type. Use it to narrow
+         * fixed point values: `int_sat16_t::rounding_shift_right(accumulator, 15)`.
+         * @param  a     Integral operand
+         * @param  shift Number of bits
+         * @return       New saturating type
+         */
+        template <typename U>
+        static constexpr std::enable_if_t<std::is_integral_v<U> && std::is_integral_v<value_type>, type>
+        __attribute__((const))
+        rounding_shift_right(const U a, unsigned shift) noexcept {
+            return { saturating::rounding_shift_right<value_type, MIN, MAX>(a, shift) };
+        }
+
         constexpr auto& operator++() noexcept {
-            if (value < MAX - 1) ++value;
+            value = saturating::increment<value_type, MIN, MAX>(value);
             return *this;
         }
         constexpr auto operator++(int) noexcept {
-            type<type, MIN, MAX> temp { value };
-            if (value < MAX - 1) ++value;
+            const type temp { value };
+            value = saturating::increment<value_type, MIN, MAX>(value);
             return temp;
         }
 
         constexpr auto& operator--() noexcept {
-            if (value > MIN + 1) --value;
+            value = saturating::decrement<value_type, MIN, MAX>(value);
             return *this;
         }
         constexpr auto operator--(int) noexcept {
-            type<type, MIN, MAX> temp { value };
-            if (value > MIN + 1) --value;
+            const type temp { value };
+            value = saturating::decrement<value_type, MIN, MAX>(value);
             return temp;
         }
 
+        constexpr type __attribute__((pure)) operator-() const noexcept { return negate(value); }
+
         template <typename U> constexpr auto& operator= (const U& other) noexcept { value = clamp(other); return *this; }
 
-        template <typename U> constexpr decltype(auto) __attribute__((const)) operator+(const U& other) const noexcept { return add(value, other); }
-        template <typename U> constexpr decltype(auto) __attribute__((const)) operator-(const U& other) const noexcept { return subtract(value, other); }
-        template <typename U> constexpr decltype(auto) __attribute__((const)) operator*(const U& other) const noexcept { return multiply(value, other); }
-        template <typename U> constexpr decltype(auto) __attribute__((const)) operator/(const U& other) const noexcept { return divide(value, other); }
+        template <typename U> constexpr decltype(auto) __attribute__((pure)) operator+(const U& other) const noexcept { return add(value, other); }
+        template <typename U> constexpr decltype(auto) __attribute__((pure)) operator-(const U& other) const noexcept { return subtract(value, other); }
+        template <typename U> constexpr decltype(auto) __attribute__((pure)) operator*(const U& other) const noexcept { return multiply(value, other); }
+        template <typename U> constexpr decltype(auto) __attribute__((pure)) operator/(const U& other) const noexcept { return divide(value, other); }
 
-        template <typename U> constexpr type __attribute__((const)) operator%(const U& other) const noexcept { return value % other; }
+        template <typename U> constexpr type __attribute__((pure)) operator%(const U& other) const noexcept { return modulo(value, other); }
+        template <typename U> constexpr std::enable_if_t<std::is_integral_v<U>, type> __attribute__((pure)) operator<<(const U& shift) const noexcept { return shift_left(value, shift); }
 
         template <typename U> constexpr auto& operator+=(const U& other) noexcept { value = add(value, other); return *this; }
         template <typename U> constexpr auto& operator-=(const U& other) noexcept { value = subtract(value, other); return *this; }
         template <typename U> constexpr auto& operator*=(const U& other) noexcept { value = multiply(value, other); return *this; }
         template <typename U> constexpr auto& operator/=(const U& other) noexcept { value = divide(value, other); return *this; }
-        template <typename U> constexpr auto& operator%=(const U& other) noexcept { value %= other; return *this; }
+        template <typename U> constexpr auto& operator%=(const U& other) noexcept { value = modulo(value, other); return *this; }
+        template <typename U> constexpr std::enable_if_t<std::is_integral_v<U>, type&> operator<<=(const U& shift) noexcept { value = shift_left(value, shift); return *this; }
 
         /**
          * Clamp value `val` to the base type limits. With float rounding.
          */
         template <typename U>
         static constexpr type __attribute__((const))
-        clamp(const U& val) noexcept {
+        clamp(const U val) noexcept {
             if constexpr (std::is_floating_point_v<U> && std::is_integral_v<value_type>) {
-                return static_cast<value_type>(minmax(MIN, round(val), MAX));
+                return static_cast<value_type>(saturating::clamp(MIN, saturating::round<value_type>(val), MAX));
             } else {
-                return static_cast<value_type>(minmax(MIN, val, MAX));
+                return static_cast<value_type>(saturating::clamp(MIN, val, MAX));
             }
         }
 
@@ -178,7 +298,7 @@ namespace saturating {
          * @return     Saturating type with initial value clamped.
          */
         template <typename U>
-        static constexpr type __attribute__((const)) from(const U& val) noexcept {
+        static constexpr type __attribute__((const)) from(const U val) noexcept {
             return { clamp(val) };
         }
 
@@ -200,7 +320,7 @@ namespace saturating {
                   std::conditional_t<std::is_floating_point_v<U>, int, std::decay_t<U>> in_max,
                   typename DISCARD = void>
         static constexpr type __attribute__((const))
-        scale_from(const type<U, in_min, in_max>& val) noexcept {
+        scale_from(const type<U, in_min, in_max> val) noexcept {
             if constexpr (static_cast<fit_all_t<type, std::decay_t<U>>>(MIN) == static_cast<fit_all_t<type, std::decay_t<U>>>(in_min)) {
                 if constexpr (static_cast<fit_all_t<type, std::decay_t<U>>>(MAX) == static_cast<fit_all_t<type, std::decay_t<U>>>(in_max)) {
                     return { static_cast<value_type>(val) };
@@ -228,14 +348,18 @@ namespace saturating {
         template <typename U, typename V>
         static constexpr std::enable_if_t<std::is_floating_point_v<U> & std::is_floating_point_v<V>, type>
         __attribute__((const))
-        scale_from(const U& val,
-                   const V& in_min,
-                   const V& in_max) noexcept
+        scale_from(const U val,
+                   const V in_min,
+                   const V in_max) noexcept
         {
             auto temp = (val - in_min) *
                         (static_cast<next_up_t<T>>(MAX) - MIN) /
                         (in_max - in_min) + MIN;
-            return { static_cast<value_type>(temp + 0.5f) };
+            if constexpr (std::is_integral_v<value_type>) {
+                return { static_cast<value_type>(saturating::clamp(MIN, saturating::round<value_type>(temp), MAX)) };
+            } else {
+                return { static_cast<value_type>(temp) };
+            }
         }
 
         // template <typename U, typename V = int>
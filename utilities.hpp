@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <limits>
@@ -16,14 +17,103 @@ namespace saturating {
     using arithmetic_type_tools::fit_all_t;
     using arithmetic_type_tools::next_up_t;
 
+    /**
+     * Signed integral able to hold the negation, difference or magnitude of any values of `T...`
+     * (integrals of up to 64 bits). 128 bit operands fall back to `__int128_t` itself, which does
+     * not widen them: check `widens_v` and use the overflow builtins for those.
+     */
+    template <typename... T>
+    using wide_signed_t = std::conditional_t<(std::max({ sizeof(T)... }) <= sizeof(int32_t)), int64_t,
+#ifdef __SIZEOF_INT128__
+                          __int128_t>;
+#else
+                          void>;
+#endif
+
+    /** Does `wide_signed_t<T...>` hold the sums, differences and negations of all values of `T...`? */
+    template <typename... T>
+    constexpr bool widens_v = std::max({ sizeof(T)... }) <= sizeof(int64_t);
+
+    /** Unsigned counterpart of `wide_signed_t` (`std::make_unsigned` does not accept `__int128` in strict mode). */
+    template <typename... T>
+    using wide_unsigned_t = std::conditional_t<std::is_same_v<wide_signed_t<T...>, int64_t>, uint64_t,
+#ifdef __SIZEOF_INT128__
+                                               __uint128_t>;
+#else
+                                               void>;
+#endif
+
+    /**
+     * Round a floating point value half away from zero, like `std::round`, but usable in constant
+     * expressions. Values too large to have a fractional part, infinities and NaN are returned as is.
+     */
+    template <typename T>
+    constexpr std::enable_if_t<std::is_floating_point_v<T>, T> __attribute__((const))
+    round_half_away(const T val) noexcept {
+        constexpr T integral_limit = static_cast<T>(1ull << (std::numeric_limits<T>::digits - 1));
+        if (__builtin_is_constant_evaluated()) {
+            if (!(val < integral_limit && val > -integral_limit)) return val;
+            const T truncated = static_cast<T>(static_cast<long long>(val));
+            const T fraction = val - truncated; // Exact, `truncated` shares the exponent range of `val`
+            return fraction >= static_cast<T>(0.5)
+                    ? truncated + 1
+                    : (fraction <= static_cast<T>(-0.5) ? truncated - 1 : truncated);
+        } else {
+            return std::round(val);
+        }
+    }
+
+    /**
+     * Round a floating point value to nearest, halfway cases to even, like `std::nearbyint` in the
+     * default rounding mode, but usable in constant expressions. Values too large to have a
+     * fractional part, infinities and NaN are returned as is.
+     */
+    template <typename T>
+    constexpr std::enable_if_t<std::is_floating_point_v<T>, T> __attribute__((const))
+    round_half_even(const T val) noexcept {
+        // Adding 2^(digits - 1) leaves no fraction bits, so the addition itself rounds to even
+        constexpr T integral_limit = static_cast<T>(1ull << (std::numeric_limits<T>::digits - 1));
+        if (!(val < integral_limit && val > -integral_limit)) return val;
+        return val >= 0 ? (val + integral_limit) - integral_limit : (val - integral_limit) + integral_limit;
+    }
+
+    /**
+     * Round a floating point value to the nearest `R`, halfway cases away from zero, saturating at the
+     * limits of `R`. NaN converts to zero. Usable in constant expressions.
+     */
+    template <typename R, typename Tin>
+    constexpr std::enable_if_t<std::is_integral_v<R> && std::is_floating_point_v<Tin>, R> __attribute__((const))
+    round_saturate(const Tin val) noexcept {
+        const Tin rounded = round_half_away(val);
+        // The limits are 2^n - 1 and -2^n (or 0), converting them to `Tin` is either exact or
+        // rounds the maximum up to 2^n, either way `>=` / `<=` select exactly the unrepresentable values.
+        if (rounded >= static_cast<Tin>(std::numeric_limits<R>::max())) {
+            return std::numeric_limits<R>::max();
+        } else if (rounded <= static_cast<Tin>(std::numeric_limits<R>::lowest())) {
+            return std::numeric_limits<R>::lowest();
+        } else if (rounded != rounded) {
+            return 0;
+        }
+        return static_cast<R>(rounded);
+    }
+
+    /**
+     * Round a floating point value to an integral wide enough for `Tout`, saturating at its limits.
+     * Constant evaluable, unlike the `std::lround` family it replaces.
+     */
     template <typename Tout, typename Tin>
-    constexpr decltype(auto) __attribute__((const))
-    round(const Tin& val) {
-        // Yup, the return types differ, but it seems the `constexpr` okays this for GCC at least
+    constexpr auto __attribute__((const))
+    round(const Tin val) noexcept {
         if constexpr (sizeof(Tout) > sizeof(long)) {
-            return std::llround(val);
+            if constexpr (std::is_unsigned_v<Tout>) {
+                return round_saturate<unsigned long long>(val);
+            } else {
+                return round_saturate<long long>(val);
+            }
+        } else if constexpr (std::is_unsigned_v<Tout> && sizeof(Tout) == sizeof(long)) {
+            return round_saturate<unsigned long>(val);
         } else {
-            return std::lround(val);
+            return round_saturate<long>(val);
         }
     }
 
@@ -32,7 +122,7 @@ namespace saturating {
      */
     template <typename TA, typename TB>
     constexpr bool __attribute__((const))
-    fp_safe_equals(const TA& a, const TB& b) noexcept {
+    fp_safe_equals(const TA a, const TB b) noexcept {
         using A = std::decay_t<TA>;
         using B = std::decay_t<TB>;
         if constexpr (std::is_floating_point_v<A>) {